@@ -0,0 +1,94 @@
+﻿#include <quill/Backend.h>
+#include <quill/Frontend.h>
+#include <quill/LogMacros.h>
+#include <quill/sinks/NullSink.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Compares caller latency of logging into frontend queue allocated from regular and huge pages. Each variant logs from
+// its own new thread, because queue of thread is allocated by first frontend it uses
+namespace {
+constexpr size_t kQueueCapacity = 64u * 1024u * 1024u;
+constexpr size_t kMessagesCount = 4'000'000;
+constexpr size_t kWarmUpCount   = 100'000;
+
+struct RegularPagesOptions : quill::FrontendOptions
+{
+    static constexpr size_t initial_queue_capacity            = kQueueCapacity;
+    static constexpr quill::HugePagesPolicy huge_pages_policy = quill::HugePagesPolicy::Never;
+};
+
+struct HugePagesOptions : quill::FrontendOptions
+{
+    static constexpr size_t initial_queue_capacity            = kQueueCapacity;
+    static constexpr quill::HugePagesPolicy huge_pages_policy = quill::HugePagesPolicy::Try;
+};
+
+template <class TFrontendOptions>
+std::vector<uint64_t> measureCallerLatency(std::string_view name)
+{
+    using Frontend = quill::FrontendImpl<TFrontendOptions>;
+
+    auto* logger = Frontend::create_or_get_logger(
+        std::string(name), Frontend::template create_or_get_sink<quill::NullSink>(std::string(name) + "NullSink"));
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(kMessagesCount);
+
+    std::thread producer(
+        [&]()
+        {
+            Frontend::preallocate();
+            for (size_t i = 0; i < kWarmUpCount; ++i)
+            {
+                QUILL_LOG_INFO(logger, "Warm up {} {}", i, 0.5);
+            }
+            logger->flush_log();
+
+            for (size_t i = 0; i < kMessagesCount; ++i)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                QUILL_LOG_INFO(logger, "Order {} price {} qty {}", i, 101.25, 7);
+                const auto end = std::chrono::steady_clock::now();
+                latencies.push_back(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+            }
+            logger->flush_log();
+        });
+    producer.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+uint64_t getPercentile(const std::vector<uint64_t>& sortedLatencies, double percentile)
+{
+    constexpr double kHundredPercent = 100.0;
+    const auto index = static_cast<size_t>(percentile / kHundredPercent * static_cast<double>(sortedLatencies.size() - 1));
+    return sortedLatencies[index];
+}
+
+void printLatencies(std::string_view name, const std::vector<uint64_t>& sortedLatencies)
+{
+    std::cout << name << " caller latency ns: p50=" << getPercentile(sortedLatencies, 50.0)
+              << " p90=" << getPercentile(sortedLatencies, 90.0) << " p99=" << getPercentile(sortedLatencies, 99.0)
+              << " p99.9=" << getPercentile(sortedLatencies, 99.9) << " max=" << sortedLatencies.back() << '\n';
+}
+}  // namespace
+
+int main()
+{
+    quill::Backend::start();
+
+    printLatencies("Regular pages", measureCallerLatency<RegularPagesOptions>("RegularPages"));
+    printLatencies("Huge pages   ", measureCallerLatency<HugePagesOptions>("HugePages"));
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+﻿#include <logger/CategorizedLogger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+// Compares caller cost of message dropped by category level: plain compare of level with level of category logger,
+// CAT_LOG_ENABLED guard, CAT_LOG_*_LAZY and CAT_LOG_* with expensive argument. Each variant is measured few times, best
+// run is taken
+namespace logger {
+GENENUM(uint8_t, BenchmarkSource, Core, Other);
+DEFINE_CAT_LOGGER_MODULE_INITIALIZATION(Benchmark, BenchmarkSources, 32);
+}  // namespace logger
+
+namespace {
+constexpr size_t kChecksCount = 10'000'000;
+constexpr size_t kRunsCount   = 5;
+
+// Result is used, so compiler doesn't remove calls
+volatile size_t s_argumentsCount = 0;
+
+std::string dumpBook(size_t i)
+{
+    s_argumentsCount = s_argumentsCount + 1;
+    return std::string(64, static_cast<char>('a' + i % 26));
+}
+
+template <class TCheck>
+void printVariant(const char* name, TCheck&& check)
+{
+    double best = std::numeric_limits<double>::max();
+    for (size_t run = 0; run < kRunsCount; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kChecksCount; ++i)
+        {
+            check(i);
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        best = std::min(best, static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) /
+                                  static_cast<double>(kChecksCount));
+    }
+    std::printf("%-20s %12.3f\n", name, best);
+}
+}  // namespace
+
+int main()
+{
+    using logger::BenchmarkSources;
+
+    auto& module = logger::s_BenchmarkLogger;
+    module.setLogLevel(BenchmarkSources::Core, logger::LogSink::Console, quill::LogLevel::None);
+    module.setLogLevel(BenchmarkSources::Core, logger::LogSink::File, quill::LogLevel::Info);
+
+    auto* coreLogger = module.getLogger(BenchmarkSources::Core);
+
+    std::printf("%-20s %12s\n", "variant", "dropped_ns");
+
+    printVariant("level compare",
+        [coreLogger](size_t i)
+        {
+            if (coreLogger->should_log_statement(quill::LogLevel::Debug))
+            {
+                s_argumentsCount = i;
+            }
+        });
+
+    printVariant("CAT_LOG_ENABLED",
+        [](size_t i)
+        {
+            if (CAT_LOG_ENABLED(Benchmark, BenchmarkSources, Core, Debug))
+            {
+                s_argumentsCount = i;
+            }
+        });
+
+    printVariant("CAT_LOG_DEBUG_LAZY",
+        [](size_t i) { CAT_LOG_DEBUG_LAZY(Benchmark, BenchmarkSources, Core, "Book {}", [i]() { return dumpBook(i); }); });
+
+    printVariant("CAT_LOG_DEBUG",
+        [](size_t i) { CAT_LOG_DEBUG(Benchmark, BenchmarkSources, Core, "Book {}", dumpBook(i)); });
+
+    return 0;
+}
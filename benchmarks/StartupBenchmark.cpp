@@ -0,0 +1,246 @@
+﻿#include <logger/CategorizedLogger.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Measures construction of logger modules for different count of categories and modules. Quill keeps loggers, sinks and
+// backend per process, so each configuration is measured in its own forked process
+namespace {
+std::atomic<uint64_t> s_allocations{0};
+std::atomic<uint64_t> s_allocatedBytes{0};
+}  // namespace
+
+void* operator new(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+// Not inlined, otherwise compiler sees memory from operator new released by free
+[[gnu::noinline]] void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+constexpr size_t kMaxModulesCount      = 32;
+constexpr size_t kCategoryNameSize     = 12;
+constexpr size_t kNanosecondsInMicro   = 1000;
+constexpr std::string_view kWorkingDir = "LoggerStartupBenchmark";
+
+// Category type with same interface as GENENUM, so count of categories can be template parameter
+template <size_t CategoriesCount>
+struct SyntheticCategories
+{
+    using baseType = uint16_t;
+
+    static constexpr baseType getSize()
+    {
+        return CategoriesCount;
+    }
+
+    static constexpr size_t maxSourceStringLength()
+    {
+        return kCategoryNameSize - 1;
+    }
+
+    static constexpr std::string_view toString(baseType category)
+    {
+        return std::string_view(kNames[category].data(), kCategoryNameSize - 1);
+    }
+
+private:
+    static constexpr auto kNames = []()
+    {
+        constexpr uint32_t kDecimalBase = 10;
+
+        std::array<std::array<char, kCategoryNameSize>, CategoriesCount> names{};
+        for (size_t i = 0; i < CategoriesCount; ++i)
+        {
+            constexpr std::string_view kPrefix = "Category";
+            std::copy(kPrefix.begin(), kPrefix.end(), names[i].begin());
+
+            auto number = static_cast<uint32_t>(i);
+            for (size_t digit = kCategoryNameSize - 2; digit >= kPrefix.size(); --digit)
+            {
+                names[i][digit] = static_cast<char>('0' + number % kDecimalBase);
+                number /= kDecimalBase;
+            }
+        }
+        return names;
+    }();
+};
+
+template <size_t ModuleIndex>
+inline constexpr char kModuleName[] = {'M', 'o', 'd', 'u', 'l', 'e', static_cast<char>('0' + ModuleIndex / 10),
+    static_cast<char>('0' + ModuleIndex % 10), '\0'};
+
+template <size_t CategoriesCount, size_t ModuleIndex>
+using Module = logger::CategorizedLogger<SyntheticCategories<CategoriesCount>, kModuleName<ModuleIndex>>;
+
+struct SyscallCounters
+{
+    uint64_t reads  = 0;
+    uint64_t writes = 0;
+};
+
+// Read and write syscalls of all threads of process
+SyscallCounters getSyscallCounters()
+{
+    SyscallCounters counters;
+
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    uint64_t value = 0;
+    while (io >> key >> value)
+    {
+        if (key == "syscr:")
+        {
+            counters.reads = value;
+        }
+        else if (key == "syscw:")
+        {
+            counters.writes = value;
+        }
+    }
+    return counters;
+}
+
+struct Result
+{
+    uint64_t totalNs = 0;
+    logger::StartupProfile profile;
+    uint64_t allocations    = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t rwSyscalls     = 0;
+};
+
+template <size_t CategoriesCount, size_t... ModuleIndexes>
+Result measure(size_t modulesCount, std::index_sequence<ModuleIndexes...>)
+{
+    std::vector<std::shared_ptr<void>> modules;
+    modules.reserve(kMaxModulesCount);
+
+    Result result;
+    const auto addProfile = [&result](const logger::StartupProfile& profile)
+    {
+        result.profile.loadSettingsNs += profile.loadSettingsNs;
+        result.profile.sinksNs += profile.sinksNs;
+        result.profile.backendStartNs += profile.backendStartNs;
+    };
+
+    const auto syscallsBefore    = getSyscallCounters();
+    const auto allocationsBefore = s_allocations.load(std::memory_order_relaxed);
+    const auto bytesBefore       = s_allocatedBytes.load(std::memory_order_relaxed);
+    const auto start             = std::chrono::steady_clock::now();
+
+    (
+        [&]()
+        {
+            if (ModuleIndexes < modulesCount)
+            {
+                auto module = std::make_shared<Module<CategoriesCount, ModuleIndexes>>();
+                addProfile(module->getStartupProfile());
+                modules.push_back(std::move(module));
+            }
+        }(),
+        ...);
+
+    const auto end           = std::chrono::steady_clock::now();
+    const auto syscallsAfter = getSyscallCounters();
+
+    result.totalNs        = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    result.allocations    = s_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+    result.allocatedBytes = s_allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+    result.rwSyscalls = (syscallsAfter.reads - syscallsBefore.reads) + (syscallsAfter.writes - syscallsBefore.writes);
+    return result;
+}
+
+template <size_t CategoriesCount>
+void runInChildProcess(size_t modulesCount)
+{
+    std::fflush(stdout);
+
+    const auto pid = fork();
+    if (pid != 0)
+    {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        return;
+    }
+
+    const auto workingDir = std::filesystem::temp_directory_path() / kWorkingDir;
+    std::filesystem::remove_all(workingDir);
+    std::filesystem::create_directories(workingDir);
+    std::filesystem::current_path(workingDir);
+
+    const auto result = measure<CategoriesCount>(modulesCount, std::make_index_sequence<kMaxModulesCount>{});
+
+    const auto profiledNs = result.profile.loadSettingsNs + result.profile.sinksNs + result.profile.backendStartNs;
+    const auto otherNs    = result.totalNs > profiledNs ? result.totalNs - profiledNs : 0;
+
+    std::printf("%10zu %8zu %12llu %14llu %10llu %12llu %10llu %10llu %12llu %11llu\n", CategoriesCount, modulesCount,
+        static_cast<unsigned long long>(result.totalNs / kNanosecondsInMicro),
+        static_cast<unsigned long long>(result.profile.loadSettingsNs / kNanosecondsInMicro),
+        static_cast<unsigned long long>(result.profile.sinksNs / kNanosecondsInMicro),
+        static_cast<unsigned long long>(result.profile.backendStartNs / kNanosecondsInMicro),
+        static_cast<unsigned long long>(otherNs / kNanosecondsInMicro),
+        static_cast<unsigned long long>(result.allocations), static_cast<unsigned long long>(result.allocatedBytes),
+        static_cast<unsigned long long>(result.rwSyscalls));
+    std::fflush(stdout);
+
+    // Loggers are not destroyed, only construction is measured
+    std::_Exit(0);
+}
+
+template <size_t CategoriesCount>
+void runForModulesCounts()
+{
+    for (const size_t modulesCount : {1, 4, 12, 32})
+    {
+        runInChildProcess<CategoriesCount>(modulesCount);
+    }
+}
+}  // namespace
+
+int main()
+{
+    // Other is time outside of profiled parts, mostly construction of module state
+    std::printf("%10s %8s %12s %14s %10s %12s %10s %10s %12s %11s\n", "categories", "modules", "total_us", "settings_us",
+        "sinks_us", "backend_us", "other_us", "allocs", "alloc_bytes", "rw_syscalls");
+
+    runForModulesCounts<1>();
+    runForModulesCounts<8>();
+    runForModulesCounts<64>();
+    runForModulesCounts<150>();
+    runForModulesCounts<512>();
+
+    return 0;
+}
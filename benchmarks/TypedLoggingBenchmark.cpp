@@ -0,0 +1,87 @@
+﻿#include <logger/CategorizedLogger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+
+// Compares caller cost of CAT_LOG_* defines with logger::log and CategoryHandle, for message which is written and for
+// message dropped by category level. Each variant is measured few times, best run is taken
+namespace logger {
+GENENUM(uint8_t, BenchmarkSource, Core, Other);
+DEFINE_CAT_LOGGER_MODULE_INITIALIZATION(Benchmark, BenchmarkSources, 32);
+}  // namespace logger
+
+namespace {
+constexpr size_t kMessagesCount = 1'000'000;
+constexpr size_t kRunsCount     = 5;
+
+template <class TLogMessage>
+double measureNsPerMessage(TLogMessage&& logMessage)
+{
+    auto* coreLogger = logger::s_BenchmarkLogger.getLogger(logger::BenchmarkSources::Core);
+
+    double best = std::numeric_limits<double>::max();
+    for (size_t run = 0; run < kRunsCount; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kMessagesCount; ++i)
+        {
+            logMessage(i);
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        // Queue is drained between runs, so next run doesn't grow it
+        coreLogger->flush_log();
+        best = std::min(best, static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) /
+                                  static_cast<double>(kMessagesCount));
+    }
+    return best;
+}
+
+template <class TLogMessage>
+void printVariant(const char* name, TLogMessage&& logMessage)
+{
+    auto& module = logger::s_BenchmarkLogger;
+    module.setLogLevel(logger::BenchmarkSources::Core, logger::LogSink::File, quill::LogLevel::Info);
+
+    const auto writtenNs = measureNsPerMessage([&](size_t i) { logMessage(quill::LogLevel::Info, i); });
+    const auto droppedNs = measureNsPerMessage([&](size_t i) { logMessage(quill::LogLevel::Debug, i); });
+    std::printf("%-16s %12.2f %12.2f\n", name, writtenNs, droppedNs);
+}
+}  // namespace
+
+int main()
+{
+    using logger::BenchmarkSources;
+
+    auto& module = logger::s_BenchmarkLogger;
+    module.setLogLevel(BenchmarkSources::Core, logger::LogSink::Console, quill::LogLevel::None);
+    module.warmUpThisThread({.prefaultQueue = true});
+
+    std::printf("%-16s %12s %12s\n", "variant", "written_ns", "dropped_ns");
+
+    // Defines take level as token, so level of message is selected by branch, as in code which logs by condition
+    printVariant("CAT_LOG_*",
+        [](quill::LogLevel logLevel, size_t i)
+        {
+            if (logLevel == quill::LogLevel::Info)
+            {
+                CAT_LOG_INFO(Benchmark, BenchmarkSources, Core, "Order {} price {}", i, 101.25);
+            }
+            else
+            {
+                CAT_LOG_DEBUG(Benchmark, BenchmarkSources, Core, "Order {} price {}", i, 101.25);
+            }
+        });
+
+    printVariant("logger::log",
+        [](quill::LogLevel logLevel, size_t i)
+        { logger::log<logger::s_BenchmarkLogger, BenchmarkSources::Core>(logLevel, "Order {} price {}", i, 101.25); });
+
+    const logger::CategoryHandle<logger::s_BenchmarkLogger, BenchmarkSources::Core> core;
+    printVariant("CategoryHandle", [&core](quill::LogLevel logLevel, size_t i) { core.log(logLevel, "Order {} price {}", i, 101.25); });
+
+    return 0;
+}
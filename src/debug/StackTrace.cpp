@@ -2,12 +2,32 @@
 
 #include <boost/stacktrace.hpp>
 #include <logger/CategorizedLogger.hpp>
+#include <logger/PeriodicReporter.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <Windows.h>
 #endif
 
-quill::Logger* s_crashLogger;
+logger::Logger* s_crashLogger;
+
+struct StackTraceRecord
+{
+    uint64_t seenCount;
+    uint64_t seenCountAtLastSummary;
+};
+
+constexpr auto kStackTraceSummaryInterval = std::chrono::seconds(60);
+
+std::mutex s_stackTracesMutex;
+std::unordered_map<uint64_t, StackTraceRecord> s_stackTraces;
+
+// Logger of last logged stack trace, summary is written by it
+std::atomic<logger::Logger*> s_stackTraceSummaryLogger{nullptr};
 
 void* getDLPointer(const void* address) noexcept
 {
@@ -22,11 +42,10 @@ void* getDLPointer(const void* address) noexcept
     return (void*)address;
 }
 
-std::string getStackTraceAsFormattedString()
+std::string getStackTraceAsFormattedString(const boost::stacktrace::stacktrace& st)
 {
-    auto st = boost::stacktrace::stacktrace().as_vector();
     std::string log;
-    for (const auto& frame : st)
+    for (const auto& frame : st.as_vector())
     {
         std::stringstream s;
         s << getDLPointer(frame.address());
@@ -42,11 +61,102 @@ std::string getStackTraceAsFormattedString()
     return log;
 }
 
+// Hash of frame addresses. On Linux addresses are module-relative, so the same stack gets the same id between runs
+// of the same binary. Elsewhere absolute addresses are hashed and ids are stable only within one run
+uint64_t getStackTraceId(const boost::stacktrace::stacktrace& st) noexcept
+{
+    constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+    constexpr uint64_t kFnvPrime       = 1099511628211ULL;
+
+    uint64_t hash = kFnvOffsetBasis;
+    for (const auto& frame : st.as_vector())
+    {
+        auto address = reinterpret_cast<uintptr_t>(getDLPointer(frame.address()));
+        for (size_t i = 0; i < sizeof(address); ++i)
+        {
+            hash ^= static_cast<uint8_t>(address >> (i * 8));
+            hash *= kFnvPrime;
+        }
+    }
+    return hash;
+}
+
+void logStackTraceSummaryLocked(logger::Logger* logger)
+{
+    for (auto& [id, record] : s_stackTraces)
+    {
+        if (record.seenCount == record.seenCountAtLastSummary)
+        {
+            continue;
+        }
+
+        QUILL_LOG_NOTICE(logger, "stack#{:016x} seen {} times (+{} since last summary)", id, record.seenCount,
+            record.seenCount - record.seenCountAtLastSummary);
+        record.seenCountAtLastSummary = record.seenCount;
+    }
+}
+
+void logDeduplicatedStackTrace(logger::Logger* logger, quill::LogLevel logLevel, std::string_view prefix)
+{
+    if (logger == nullptr)
+    {
+        return;
+    }
+
+    boost::stacktrace::stacktrace st;
+    const auto id = getStackTraceId(st);
+
+    // Crash handlers can run while the mutex is held by the crashed thread, so never wait for it.
+    // Without the lock the trace is logged in full, same as before deduplication existed
+    std::unique_lock lock(s_stackTracesMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        QUILL_LOG_DYNAMIC(logger, logLevel, "{} stack#{:016x} {}", prefix, id, getStackTraceAsFormattedString(st));
+        return;
+    }
+
+    auto [it, inserted] = s_stackTraces.try_emplace(id, StackTraceRecord{0, 0});
+    ++it->second.seenCount;
+    s_stackTraceSummaryLogger.store(logger, std::memory_order_relaxed);
+
+    if (inserted)
+    {
+        QUILL_LOG_DYNAMIC(logger, logLevel, "{} stack#{:016x} {}", prefix, id, getStackTraceAsFormattedString(st));
+        return;
+    }
+
+    QUILL_LOG_DYNAMIC(logger, logLevel, "{} stack#{:016x} (seen {} times)", prefix, id, it->second.seenCount);
+}
+
+// Summary is written by timer, so final count of stack which stopped recurring is reported too. Timer isn't started
+// from crash handlers
+void startStackTraceSummaryTimer()
+{
+    static std::once_flag started;
+    std::call_once(started,
+        []()
+        {
+            logger::getPeriodicReporter().addTask(
+                []()
+                {
+                    auto* logger = s_stackTraceSummaryLogger.load(std::memory_order_relaxed);
+                    if (logger == nullptr)
+                    {
+                        return;
+                    }
+
+                    std::lock_guard lock(s_stackTracesMutex);
+                    logStackTraceSummaryLocked(logger);
+                },
+                kStackTraceSummaryInterval);
+        });
+}
+
 #if defined(_WIN32) || defined(_WIN64)
 
 LONG WINAPI unhandledExceptionFilter(_EXCEPTION_POINTERS* ExceptionInfo)
 {
-    QUILL_LOG_CRITICAL(s_crashLogger, "CRASH {}", getStackTraceAsFormattedString());
+    logDeduplicatedStackTrace(s_crashLogger, quill::LogLevel::Critical, "CRASH");
     return 0;
 }
 
@@ -56,7 +166,7 @@ LONG WINAPI unhandledExceptionFilter(_EXCEPTION_POINTERS* ExceptionInfo)
 
 void signalHandler(int signum)
 {
-    QUILL_LOG_CRITICAL(s_crashLogger, "CRASH {}", getStackTraceAsFormattedString());
+    logDeduplicatedStackTrace(s_crashLogger, quill::LogLevel::Critical, "CRASH");
     exit(-1);
 }
 
@@ -75,9 +185,10 @@ void setupSignals()
 
 #endif
 
-void debug::setStackTraceOutputOnCrash(quill::Logger* logger)
+void debug::setStackTraceOutputOnCrash(logger::Logger* logger)
 {
     s_crashLogger = logger;
+    startStackTraceSummaryTimer();
 
     // if this line fails compile, then you probably should build boost with backtrace extension
     // boost from apt doesn't have backtrace support
@@ -89,7 +200,7 @@ void debug::setStackTraceOutputOnCrash(quill::Logger* logger)
     std::set_terminate(
         []()
         {
-            QUILL_LOG_CRITICAL(s_crashLogger, "Crash {}", getStackTraceAsFormattedString());
+            logDeduplicatedStackTrace(s_crashLogger, quill::LogLevel::Critical, "Crash");
             exit(-1);
         });
 #elif defined(_WIN32) || defined(_WIN64)
@@ -99,8 +210,25 @@ void debug::setStackTraceOutputOnCrash(quill::Logger* logger)
     std::set_terminate(
         []()
         {
-            QUILL_LOG_CRITICAL(s_crashLogger, "Crash {}", getStackTraceAsFormattedString());
+            logDeduplicatedStackTrace(s_crashLogger, quill::LogLevel::Critical, "Crash");
             exit(-1);
         });
 #endif
 }
+
+void debug::logStackTrace(logger::Logger* logger, quill::LogLevel logLevel, std::string_view prefix)
+{
+    startStackTraceSummaryTimer();
+    logDeduplicatedStackTrace(logger, logLevel, prefix);
+}
+
+void debug::logStackTraceSummary(logger::Logger* logger)
+{
+    if (logger == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard lock(s_stackTracesMutex);
+    logStackTraceSummaryLocked(logger);
+}
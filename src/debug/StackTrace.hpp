@@ -1,10 +1,19 @@
 ﻿#ifndef LOGGER_STACK_TRACE_HPP
 #define LOGGER_STACK_TRACE_HPP
 
-#include <quill/Logger.h>
+#include <string_view>
+
+#include "logger/Frontend.hpp"
 
 namespace debug {
-void setStackTraceOutputOnCrash(quill::Logger* logger);
+void setStackTraceOutputOnCrash(logger::Logger* logger);
+
+// Logs current stack trace. Full trace is written only on first occurrence, repeats are logged as stack id with counter
+void logStackTrace(logger::Logger* logger, quill::LogLevel logLevel, std::string_view prefix = "Stack");
+
+// Logs how many times each stack trace was seen since previous summary. Same summary is written every minute by logger
+// of last logged stack trace
+void logStackTraceSummary(logger::Logger* logger);
 }  // namespace debug
 
 #endif  // LOGGER_STACK_TRACE_HPP
@@ -0,0 +1,408 @@
+﻿#include "PrometheusExporter.hpp"
+
+#include <quill/Backend.h>
+
+#include <array>
+#include <charconv>
+#include <string>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <logger/ModuleRegistry.hpp>
+
+namespace {
+constexpr int kPollTimeoutMs       = 200;
+constexpr int kReceiveTimeoutMs    = 1000;
+constexpr size_t kMaxRequestLength = 8192;
+constexpr int kListenBacklog       = 8;
+
+#if defined(_WIN32) || defined(_WIN64)
+using SocketHandle = SOCKET;
+
+void closeSocket(SocketHandle socket)
+{
+    closesocket(socket);
+}
+
+int pollSocket(SocketHandle socket)
+{
+    WSAPOLLFD pollFd{socket, POLLRDNORM, 0};
+    return WSAPoll(&pollFd, 1, kPollTimeoutMs);
+}
+
+void setReceiveTimeout(SocketHandle socket)
+{
+    DWORD timeout = kReceiveTimeoutMs;
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+constexpr int kSendFlags = 0;
+#else
+using SocketHandle = int;
+
+void closeSocket(SocketHandle socket)
+{
+    close(socket);
+}
+
+int pollSocket(SocketHandle socket)
+{
+    pollfd pollFd{socket, POLLIN, 0};
+    return poll(&pollFd, 1, kPollTimeoutMs);
+}
+
+void setReceiveTimeout(SocketHandle socket)
+{
+    constexpr int kMicrosecondsInMillisecond = 1000;
+    timeval timeout{0, kReceiveTimeoutMs * kMicrosecondsInMillisecond};
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+}
+
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#endif
+
+SocketHandle toSocket(std::intptr_t socket)
+{
+    return static_cast<SocketHandle>(socket);
+}
+
+std::string_view getTypeName(logger::PrometheusMetrics::Type type)
+{
+    switch (type)
+    {
+        case logger::PrometheusMetrics::Type::Counter: return "counter";
+        case logger::PrometheusMetrics::Type::Gauge: return "gauge";
+        case logger::PrometheusMetrics::Type::Summary: return "summary";
+    }
+    return "untyped";
+}
+
+void sendAll(SocketHandle socket, std::string_view data)
+{
+    while (!data.empty())
+    {
+        const auto sent = send(socket, data.data(), static_cast<int>(data.size()), kSendFlags);
+        if (sent <= 0)
+        {
+            return;
+        }
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+}
+}  // namespace
+
+void logger::PrometheusMetrics::declare(std::string_view family, Type type, std::string_view help)
+{
+    m_families.try_emplace(std::string(family), Family{type, std::string(help), {}});
+}
+
+void logger::PrometheusMetrics::addSample(std::string_view family, std::string_view suffix, std::string_view labels, double value)
+{
+    auto it = m_families.find(family);
+    if (it == m_families.end())
+    {
+        return;
+    }
+
+    std::array<char, 32> number{};
+    auto [end, ec] = std::to_chars(number.data(), number.data() + number.size(), value);
+
+    auto& samples = it->second.samples;
+    samples.append(family).append(suffix);
+    if (!labels.empty())
+    {
+        samples.append("{").append(labels).append("}");
+    }
+    samples.append(" ").append(number.data(), end).append("\n");
+}
+
+std::string logger::PrometheusMetrics::serialize() const
+{
+    std::string result;
+    for (const auto& [name, family] : m_families)
+    {
+        result.append("# HELP ").append(name).append(" ").append(family.help).append("\n");
+        result.append("# TYPE ").append(name).append(" ").append(getTypeName(family.type)).append("\n");
+        result.append(family.samples);
+    }
+    return result;
+}
+
+void logger::collectQueueMetrics(PrometheusMetrics& metrics)
+{
+    using Type = PrometheusMetrics::Type;
+
+    const auto stats = getQueueStats();
+
+    metrics.declare("logger_dropped_messages_total", Type::Counter, "Messages dropped because frontend queue was full");
+    metrics.declare("logger_blocked_enqueues_total", Type::Counter, "Times producer blocked on full frontend queue");
+    metrics.declare("logger_queue_largest_capacity_bytes", Type::Gauge, "Largest capacity of frontend queue of one thread");
+    metrics.declare("logger_queue_memory_bytes", Type::Gauge, "Memory of frontend queues of all threads");
+    metrics.declare("logger_queue_memory_peak_bytes", Type::Gauge, "Peak memory of frontend queues of all threads");
+    metrics.declare("logger_queue_memory_budget_bytes", Type::Gauge, "Memory budget of frontend queues, 0 is unlimited");
+    metrics.declare("logger_budget_dropped_messages_total", Type::Counter, "Messages dropped because of queue memory budget");
+    metrics.declare("logger_budget_blocked_messages_total", Type::Counter, "Messages blocked because of queue memory budget");
+    metrics.declare("logger_shrunk_queues_total", Type::Counter, "Times frontend queue was shrunk to initial capacity");
+
+    metrics.addSample("logger_dropped_messages_total", "", "", static_cast<double>(stats.droppedMessages));
+    metrics.addSample("logger_blocked_enqueues_total", "", "", static_cast<double>(stats.blockedEnqueues));
+    metrics.addSample("logger_queue_largest_capacity_bytes", "", "", static_cast<double>(stats.memory.largestQueueBytes));
+    metrics.addSample("logger_queue_memory_bytes", "", "", static_cast<double>(stats.memory.currentBytes));
+    metrics.addSample("logger_queue_memory_peak_bytes", "", "", static_cast<double>(stats.memory.peakBytes));
+    metrics.addSample("logger_queue_memory_budget_bytes", "", "", static_cast<double>(stats.memory.budgetBytes));
+    metrics.addSample("logger_budget_dropped_messages_total", "", "", static_cast<double>(stats.memory.droppedMessages));
+    metrics.addSample("logger_budget_blocked_messages_total", "", "", static_cast<double>(stats.memory.blockedMessages));
+    metrics.addSample("logger_shrunk_queues_total", "", "", static_cast<double>(stats.memory.shrunkQueues));
+}
+
+void logger::collectModuleMetrics(PrometheusMetrics& metrics, const ModuleStats& module)
+{
+    using Type = PrometheusMetrics::Type;
+
+    constexpr double kNanosecondsInSecond = 1e9;
+    constexpr std::array<double, 3> kQuantiles{50.0, 90.0, 99.0};
+    constexpr std::array<std::string_view, 3> kQuantileLabels{"0.5", "0.9", "0.99"};
+
+    metrics.declare("logger_messages_total", Type::Counter, "Messages passed to backend by category and level");
+    metrics.declare("logger_sink_written_messages_total", Type::Counter, "Messages written by sink");
+    metrics.declare("logger_sink_filtered_messages_total", Type::Counter, "Messages filtered out by sink log level");
+    metrics.declare("logger_sink_written_bytes_total", Type::Counter, "Bytes written by sink");
+    metrics.declare("logger_sink_coalesced_messages_total", Type::Counter, "Repeated messages collapsed by sink");
+    metrics.declare("logger_queue_latency_seconds", Type::Summary, "Time from log call until backend processed message");
+    metrics.declare("logger_sink_write_latency_seconds", Type::Summary, "Time spent by backend writing message to sink");
+
+    const quill::BackendOptions backendOptions;
+
+    const auto addSummary = [&](std::string_view family, const std::string& labels, const LatencyHistogram::Snapshot& snapshot)
+    {
+        for (size_t q = 0; q < kQuantiles.size(); ++q)
+        {
+            metrics.addSample(family, "", labels + ",quantile=\"" + std::string(kQuantileLabels[q]) + "\"",
+                static_cast<double>(snapshot.getPercentile(kQuantiles[q])) / kNanosecondsInSecond);
+        }
+        metrics.addSample(family, "_sum", labels, static_cast<double>(snapshot.sum) / kNanosecondsInSecond);
+        metrics.addSample(family, "_count", labels, static_cast<double>(snapshot.count));
+    };
+
+    for (size_t i = 0; i < module.categories.size(); ++i)
+    {
+        const auto& category = module.categories[i];
+        const auto labels    = "module=\"" + std::string(module.name) + "\",category=\"" + std::string(category.name) + "\"";
+
+        for (size_t level = 0; level < kLogLevelsCount; ++level)
+        {
+            metrics.addSample("logger_messages_total", "",
+                labels + ",level=\"" + std::string(backendOptions.log_level_descriptions[level]) + "\"",
+                static_cast<double>(category.messagesByLevel[level]));
+        }
+
+        for (const auto& [sinkName, sink] : {std::pair{"file", category.file}, std::pair{"console", category.console}})
+        {
+            const auto sinkLabels = labels + ",sink=\"" + sinkName + "\"";
+            metrics.addSample("logger_sink_written_messages_total", "", sinkLabels, static_cast<double>(sink.writtenMessages));
+            metrics.addSample("logger_sink_filtered_messages_total", "", sinkLabels, static_cast<double>(sink.filteredMessages));
+            metrics.addSample("logger_sink_written_bytes_total", "", sinkLabels, static_cast<double>(sink.writtenBytes));
+            metrics.addSample("logger_sink_coalesced_messages_total", "", sinkLabels, static_cast<double>(sink.coalescedMessages));
+        }
+
+        if (i < module.latencies.size())
+        {
+            const auto& latencies = module.latencies[i];
+            addSummary("logger_queue_latency_seconds", labels, latencies.queue);
+            addSummary("logger_sink_write_latency_seconds", labels + ",sink=\"file\"", latencies.fileWrite);
+            addSummary("logger_sink_write_latency_seconds", labels + ",sink=\"console\"", latencies.consoleWrite);
+        }
+    }
+}
+
+logger::PrometheusExporter::PrometheusExporter(Options options) : m_options(std::move(options))
+{
+}
+
+logger::PrometheusExporter::~PrometheusExporter()
+{
+    stop();
+}
+
+void logger::PrometheusExporter::addCollector(Collector collector)
+{
+    std::lock_guard lock(m_collectorsMutex);
+    m_collectors.push_back(std::move(collector));
+}
+
+std::string logger::PrometheusExporter::collect() const
+{
+    PrometheusMetrics metrics;
+    collectQueueMetrics(metrics);
+
+    // Registry holds only modules which are alive, so metrics never read destroyed module
+    for (const auto& module : getModuleRegistry().getStats())
+    {
+        collectModuleMetrics(metrics, module);
+    }
+
+    std::lock_guard lock(m_collectorsMutex);
+    for (const auto& collector : m_collectors)
+    {
+        collector(metrics);
+    }
+    return metrics.serialize();
+}
+
+bool logger::PrometheusExporter::start()
+{
+    if (m_running)
+    {
+        return true;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    {
+        return false;
+    }
+#endif
+
+    SocketHandle listenSocket;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (!m_options.unixSocketPath.empty())
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (m_options.unixSocketPath.size() >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        m_options.unixSocketPath.copy(address.sun_path, m_options.unixSocketPath.size());
+
+        listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(m_options.unixSocketPath.c_str());
+        if (listenSocket < 0 || bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            closeSocket(listenSocket);
+            return false;
+        }
+    }
+    else
+#endif
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port   = htons(m_options.port);
+        if (inet_pton(AF_INET, m_options.address.c_str(), &address.sin_addr) != 1)
+        {
+            return false;
+        }
+
+        listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+
+        int reuse = 1;
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+        if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            closeSocket(listenSocket);
+            return false;
+        }
+    }
+
+    if (listen(listenSocket, kListenBacklog) != 0)
+    {
+        closeSocket(listenSocket);
+        return false;
+    }
+
+    m_listenSocket = static_cast<std::intptr_t>(listenSocket);
+    m_running      = true;
+    m_thread       = std::thread([this]() { run(); });
+    return true;
+}
+
+void logger::PrometheusExporter::stop()
+{
+    if (!m_running.exchange(false))
+    {
+        return;
+    }
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    closeSocket(toSocket(m_listenSocket));
+    m_listenSocket = kInvalidSocket;
+
+#if defined(_WIN32) || defined(_WIN64)
+    WSACleanup();
+#else
+    if (!m_options.unixSocketPath.empty())
+    {
+        unlink(m_options.unixSocketPath.c_str());
+    }
+#endif
+}
+
+void logger::PrometheusExporter::run()
+{
+    const auto listenSocket = toSocket(m_listenSocket);
+    while (m_running)
+    {
+        if (pollSocket(listenSocket) <= 0)
+        {
+            continue;
+        }
+
+        const auto clientSocket = accept(listenSocket, nullptr, nullptr);
+        if (static_cast<std::intptr_t>(clientSocket) == kInvalidSocket)
+        {
+            continue;
+        }
+
+        handleClient(static_cast<std::intptr_t>(clientSocket));
+        closeSocket(clientSocket);
+    }
+}
+
+void logger::PrometheusExporter::handleClient(std::intptr_t clientSocket) const
+{
+    const auto socket = toSocket(clientSocket);
+    setReceiveTimeout(socket);
+
+    std::string request;
+    std::array<char, 1024> buffer{};
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestLength)
+    {
+        const auto received = recv(socket, buffer.data(), static_cast<int>(buffer.size()), 0);
+        if (received <= 0)
+        {
+            return;
+        }
+        request.append(buffer.data(), static_cast<size_t>(received));
+    }
+
+    if (!request.starts_with("GET /metrics ") && !request.starts_with("GET / "))
+    {
+        sendAll(socket, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+        return;
+    }
+
+    const auto body = collect();
+
+    std::string response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n";
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+    response += body;
+    sendAll(socket, response);
+}
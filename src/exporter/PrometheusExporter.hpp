@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <logger/LoggerStats.hpp>
+
+namespace logger {
+// Collects samples grouped by metric family, so families shared by several logger modules are described once
+class PrometheusMetrics
+{
+public:
+    enum class Type : uint8_t
+    {
+        Counter,
+        Gauge,
+        Summary
+    };
+
+    void declare(std::string_view family, Type type, std::string_view help);
+
+    // Labels are written as is, e.g. R"(module="Core",sink="file")". Suffix is appended to family name, e.g. "_sum"
+    void addSample(std::string_view family, std::string_view suffix, std::string_view labels, double value);
+
+    std::string serialize() const;
+
+private:
+    struct Family
+    {
+        Type type;
+        std::string help;
+        std::string samples;
+    };
+
+    std::map<std::string, Family, std::less<>> m_families;
+};
+
+// Frontend queues are process wide, so their metrics are collected once by exporter itself
+void collectQueueMetrics(PrometheusMetrics& metrics);
+
+// Statistics of one logger module, dynamic categories included
+void collectModuleMetrics(PrometheusMetrics& metrics, const ModuleStats& module);
+
+// Serves metrics in Prometheus text exposition format over HTTP on TCP port or Unix socket. Covers all logger modules
+// registered in module registry at time of request. Runs in own thread and only reads counters, so backend is never
+// paused
+class PrometheusExporter
+{
+public:
+    using Collector = std::function<void(PrometheusMetrics&)>;
+
+    struct Options
+    {
+        std::string address = "127.0.0.1";
+        uint16_t port       = 9464;
+
+        // If set, Unix socket is used instead of TCP port. Not supported on Windows
+        std::string unixSocketPath;
+    };
+
+    explicit PrometheusExporter(Options options);
+    ~PrometheusExporter();
+
+    PrometheusExporter(const PrometheusExporter&)            = delete;
+    PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+    // Logger modules are collected from module registry, collectors add other metrics
+    void addCollector(Collector collector);
+
+    // Returns false if socket could not be opened
+    bool start();
+    void stop();
+
+    std::string collect() const;
+
+private:
+    void run();
+    void handleClient(std::intptr_t clientSocket) const;
+
+    static constexpr std::intptr_t kInvalidSocket = -1;
+
+    Options m_options;
+    std::intptr_t m_listenSocket = kInvalidSocket;
+
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+
+    mutable std::mutex m_collectorsMutex;
+    std::vector<Collector> m_collectors;
+};
+}  // namespace logger
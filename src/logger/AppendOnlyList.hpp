@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace logger {
+// Storage with stable addresses of elements, which are never removed. Readers access published elements without
+// locks, appends must be serialized by caller. Memory is allocated by chunks, which are never moved
+template <class T, size_t ChunkSize = 16, size_t ChunksCount = 256>
+class AppendOnlyList
+{
+public:
+    AppendOnlyList() = default;
+
+    ~AppendOnlyList()
+    {
+        for (auto& chunk : m_chunks)
+        {
+            delete chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    AppendOnlyList(const AppendOnlyList&)            = delete;
+    AppendOnlyList& operator=(const AppendOnlyList&) = delete;
+
+    static constexpr size_t capacity() noexcept
+    {
+        return ChunkSize * ChunksCount;
+    }
+
+    // Element is constructed and initialized by init, then published to readers. Nullptr if list is full
+    template <class TInit>
+    T* append(TInit&& init)
+    {
+        const auto index = m_size.load(std::memory_order_relaxed);
+        if (index == capacity())
+        {
+            return nullptr;
+        }
+
+        auto& chunk = m_chunks[index / ChunkSize];
+        if (chunk.load(std::memory_order_relaxed) == nullptr)
+        {
+            chunk.store(new Chunk, std::memory_order_release);
+        }
+
+        auto& element = chunk.load(std::memory_order_relaxed)->elements[index % ChunkSize].emplace();
+        init(element);
+
+        m_size.store(index + 1, std::memory_order_release);
+        return &element;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    // Index must be less than size()
+    T& operator[](size_t index) noexcept
+    {
+        return *m_chunks[index / ChunkSize].load(std::memory_order_acquire)->elements[index % ChunkSize];
+    }
+
+    const T& operator[](size_t index) const noexcept
+    {
+        return *m_chunks[index / ChunkSize].load(std::memory_order_acquire)->elements[index % ChunkSize];
+    }
+
+private:
+    struct Chunk
+    {
+        std::array<std::optional<T>, ChunkSize> elements;
+    };
+
+    std::array<std::atomic<Chunk*>, ChunksCount> m_chunks{};
+    std::atomic<size_t> m_size{0};
+};
+}  // namespace logger
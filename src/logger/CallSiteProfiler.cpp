@@ -0,0 +1,96 @@
+﻿#include "CallSiteProfiler.hpp"
+
+#include <algorithm>
+
+void logger::CallSiteProfiler::record(quill::MacroMetadata const* metadata, size_t bytes)
+{
+    if (metadata != m_lastMetadata)
+    {
+        auto it = m_callSites.find(metadata);
+        if (it == m_callSites.end())
+        {
+            std::lock_guard lock(m_mutex);
+            it = m_callSites.emplace(metadata, std::make_unique<Counter>()).first;
+        }
+
+        m_lastMetadata = metadata;
+        m_lastCounter  = it->second.get();
+    }
+
+    // Single writer, so plain store is enough and doesn't lock bus
+    m_lastCounter->messages.store(m_lastCounter->messages.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_lastCounter->bytes.store(m_lastCounter->bytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+}
+
+std::vector<logger::CallSiteStats> logger::CallSiteProfiler::getTop(std::string_view category, size_t count) const
+{
+    std::vector<CallSiteStats> callSites;
+    {
+        std::lock_guard lock(m_mutex);
+
+        const auto duration = std::chrono::steady_clock::now() - m_start;
+        callSites.reserve(m_callSites.size());
+        for (const auto& [metadata, counter] : m_callSites)
+        {
+            callSites.push_back(makeStats(category, metadata, counter->messages.load(std::memory_order_relaxed),
+                counter->bytes.load(std::memory_order_relaxed), duration));
+        }
+    }
+
+    keepTop(callSites, count);
+    return callSites;
+}
+
+std::vector<logger::CallSiteStats> logger::CallSiteProfiler::takeIntervalTop(std::string_view category, size_t count)
+{
+    std::vector<CallSiteStats> callSites;
+    {
+        std::lock_guard lock(m_mutex);
+
+        const auto now      = std::chrono::steady_clock::now();
+        const auto duration = now - m_lastInterval;
+        m_lastInterval      = now;
+
+        for (auto& [metadata, counter] : m_callSites)
+        {
+            const auto totalMessages = counter->messages.load(std::memory_order_relaxed);
+            const auto totalBytes    = counter->bytes.load(std::memory_order_relaxed);
+
+            const auto messages = totalMessages - counter->messagesAtLastInterval;
+            if (messages != 0)
+            {
+                callSites.push_back(
+                    makeStats(category, metadata, messages, totalBytes - counter->bytesAtLastInterval, duration));
+            }
+            counter->messagesAtLastInterval = totalMessages;
+            counter->bytesAtLastInterval    = totalBytes;
+        }
+    }
+
+    keepTop(callSites, count);
+    return callSites;
+}
+
+void logger::CallSiteProfiler::keepTop(std::vector<CallSiteStats>& callSites, size_t count)
+{
+    const auto byRate = [](const CallSiteStats& lhs, const CallSiteStats& rhs)
+    { return lhs.messagesPerSecond > rhs.messagesPerSecond; };
+
+    if (callSites.size() > count)
+    {
+        std::partial_sort(callSites.begin(), callSites.begin() + static_cast<std::ptrdiff_t>(count), callSites.end(), byRate);
+        callSites.resize(count);
+    }
+    else
+    {
+        std::sort(callSites.begin(), callSites.end(), byRate);
+    }
+}
+
+logger::CallSiteStats logger::CallSiteProfiler::makeStats(std::string_view category, quill::MacroMetadata const* metadata,
+    uint64_t messages, uint64_t bytes, std::chrono::steady_clock::duration duration)
+{
+    const auto seconds = std::max(std::chrono::duration<double>(duration).count(), 1e-9);
+    return CallSiteStats{category, metadata->source_location(), metadata->caller_function(), metadata->message_format(),
+        metadata->log_level(), messages, bytes, static_cast<double>(messages) / seconds, static_cast<double>(bytes) / seconds};
+}
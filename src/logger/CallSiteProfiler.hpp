@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include <quill/core/LogLevel.h>
+#include <quill/core/MacroMetadata.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace logger {
+struct CallSiteStats
+{
+    std::string_view category;
+    std::string_view sourceLocation;
+    std::string_view function;
+    std::string_view format;
+    quill::LogLevel logLevel = quill::LogLevel::None;
+    uint64_t messages        = 0;
+    uint64_t bytes           = 0;
+    double messagesPerSecond = 0.0;
+    double bytesPerSecond    = 0.0;
+};
+
+// Counts messages and formatted message bytes of each log statement of one category. Statements are identified by
+// metadata quill already passes to backend, so producers do nothing extra. Counters are written only by backend
+// thread without locking, mutex is taken only for new call site and for snapshots
+class CallSiteProfiler
+{
+public:
+    // Called only by backend thread
+    void record(quill::MacroMetadata const* metadata, size_t bytes);
+
+    // Busiest call sites since start
+    std::vector<CallSiteStats> getTop(std::string_view category, size_t count) const;
+
+    // Busiest call sites since previous call
+    std::vector<CallSiteStats> takeIntervalTop(std::string_view category, size_t count);
+
+    // Sorts by rate and leaves at most count call sites
+    static void keepTop(std::vector<CallSiteStats>& callSites, size_t count);
+
+private:
+    struct Counter
+    {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+
+        // Guarded by mutex
+        uint64_t messagesAtLastInterval = 0;
+        uint64_t bytesAtLastInterval    = 0;
+    };
+
+    static CallSiteStats makeStats(std::string_view category, quill::MacroMetadata const* metadata, uint64_t messages,
+        uint64_t bytes, std::chrono::steady_clock::duration duration);
+
+    // Changed only by backend thread under mutex, so backend thread reads it without mutex
+    mutable std::mutex m_mutex;
+    std::unordered_map<quill::MacroMetadata const*, std::unique_ptr<Counter>> m_callSites;
+
+    // Storms usually come from single statement, so its counter is found without hashing. Used only by backend thread
+    quill::MacroMetadata const* m_lastMetadata = nullptr;
+    Counter* m_lastCounter                     = nullptr;
+
+    std::chrono::steady_clock::time_point m_start        = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point m_lastInterval = m_start;
+};
+}  // namespace logger
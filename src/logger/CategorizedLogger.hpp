@@ -1,24 +1,89 @@
 ﻿#pragma once
 
-#include <quill/Logger.h>
 #include <quill/Backend.h>
-#include <quill/Frontend.h>
 #include <quill/LogMacros.h>
 #include <quill/sinks/FileSink.h>
 #include <quill/sinks/ConsoleSink.h>
+#include <quill/backend/TransitEvent.h>
 
 #include <GenEnum.hpp>
 
-#include "SimpleIni.hpp"
+#include <bitset>
+#include <mutex>
+#include <optional>
+
+#include "AppendOnlyList.hpp"
+#include "CategoryHandle.hpp"
+#include "CategoryTree.hpp"
+#include "DynamicCategory.hpp"
+#include "LoggerStats.hpp"
+#include "Frontend.hpp"
+#include "LazyCategorizedLogger.hpp"
+#include "ModuleRegistry.hpp"
+#include "Numa.hpp"
+#include "ObservedSink.hpp"
+#include "PerfectHash.hpp"
+#include "PeriodicReporter.hpp"
+#include "QueueBudget.hpp"
+#include "RateLimiter.hpp"
+#include "Sampling.hpp"
+#include "SettingsFile.hpp"
+#include "ScopeTime.hpp"
+#include "TaskContext.hpp"
+#include "TraceEventSink.hpp"
+#include "WarmUp.hpp"
 
 namespace logger {
+// Keys of category section of settings file, in order of writing
+GENENUM(uint8_t, CategorySettingsKey, Console, File, SampleRate, RateLimit, RateLimitBurst, RateLimitPerLevel,
+    CoalesceWindowMs, BacktraceLength, BacktraceFlush);
+
+template <class TCategory>
+consteval auto getCategoryNames()
+{
+    std::array<std::string_view, TCategory::getSize()> names;
+    for (typename TCategory::baseType i = 0; i < TCategory::getSize(); ++i)
+    {
+        names[i] = TCategory::toString(i);
+    }
+    return names;
+}
+
+// Enum of GENENUM categories is found by reference parameter of its fromString. Types with same interface without
+// fromString use base type
+template <class TName, class TEnum>
+TEnum getCategoryEnum(bool (*)(TName, TEnum&));
+
+template <class TCategory>
+struct CategoryEnumOf
+{
+    using type = typename TCategory::baseType;
+};
+
+template <class TCategory>
+    requires requires { getCategoryEnum(&TCategory::fromString); }
+struct CategoryEnumOf<TCategory>
+{
+    using type = decltype(getCategoryEnum(&TCategory::fromString));
+};
+
+// Names of categories as declared, shared by all logger modules with same category type
+template <class TCategory>
+inline constexpr PerfectHash<TCategory::getSize()> kCategoryNames{getCategoryNames<TCategory>()};
+
 template <class T, const char* LoggerName, uint8_t BacktraceLength = 32>
 class CategorizedLogger
 {
 private:
     using Category = T;
+    using Tree     = CategoryTree<Category>;
     static_assert(Category::getSize() > 0);
+
+public:
     using BaseCategory = typename Category::baseType;
+    using CategoryEnum = typename CategoryEnumOf<Category>::type;
+
+private:
 
     struct SinksLogLevel
     {
@@ -29,31 +94,80 @@ private:
         {
             LogLevel currentLogLevel;
             LogLevel defaultLogLevel;
+            bool isInherited;  // Taken from parent section, so it is not written to section of child
         };
 
         std::map<LogSource, CurrentAndDefualtLogLevel> logLevels = {
-            {LogSources::File,    CurrentAndDefualtLogLevel{LogLevels::T3, LogLevels::T3}},
-            {LogSources::Console, CurrentAndDefualtLogLevel{LogLevels::I, LogLevels::I}  }
+            {LogSources::File,    CurrentAndDefualtLogLevel{LogLevels::T3, LogLevels::T3, false}},
+            {LogSources::Console, CurrentAndDefualtLogLevel{LogLevels::I, LogLevels::I, false}  }
         };
     };
 
+    struct CategorySettings
+    {
+        double sampleRate      = 1.0;
+        double rateLimit       = 0.0;
+        double rateLimitBurst  = 0.0;  // RateLimit if not set
+        bool rateLimitPerLevel = false;
+        long coalesceWindowMs  = 0;
+        long backtraceLength   = BacktraceLength;
+
+        typename SinksLogLevel::LogLevel backtraceFlush = SinksLogLevel::LogLevels::C;
+    };
+
+    struct CategoryState
+    {
+        CategoryCounters counters;
+        std::array<SinkRoute, SinksLogLevel::LogSources::getSize()> routes;
+    };
+
+    // Category registered at runtime has levels only, other category settings are not applied to it
+    struct DynamicCategoryState : DynamicCategoryEntry
+    {
+        SinksLogLevel sinks;
+        CategoryState state;
+    };
+
+    // Shared with sinks, because backend may write logs after logger module is destroyed
+    struct ModuleState
+    {
+        std::array<CategoryState, Category::getSize()> categories;
+        logger::Logger* internalLogger = nullptr;
+
+        std::atomic<size_t> callSiteDumpCount{0};
+
+        // Only categories with RateLimit setting have limiter
+        std::array<std::unique_ptr<CategoryRateLimiter>, Category::getSize()> rateLimiters;
+        std::chrono::steady_clock::time_point lastRateLimitReport = std::chrono::steady_clock::now();
+
+        AppendOnlyList<DynamicCategoryState> dynamicCategories;
+    };
+
+    using FileSink    = ObservedSink<quill::FileSink>;
+    using ConsoleSink = ObservedSink<quill::ConsoleSink>;
+
 public:
-    CategorizedLogger()
+    explicit CategorizedLogger(InitOptions options = {}) : m_settingsFileName(std::move(options.settingsFileName))
     {
+        const auto loadSettingsStart = std::chrono::steady_clock::now();
         loadSettings();
 
+        const auto sinksStart           = std::chrono::steady_clock::now();
+        m_startupProfile.loadSettingsNs = getElapsedNs(loadSettingsStart, sinksStart);
+
+        auto traceSink = logger::Frontend::create_or_get_sink<TraceEventSink>(std::string(kLoggerName) + kTraceSinkNameSuffix.data());
+        m_traceSink    = std::static_pointer_cast<TraceEventSink>(traceSink);
+
+        auto fileSink = getModuleRegistry().getFileSink();
         for (BaseCategory i = 0; i < Category::getSize(); ++i)
         {
-            // File Sink
-            quill::FileSinkConfig cfg;
-            cfg.set_open_mode('w');
-            cfg.set_filename_append_option(quill::FilenameAppendOption::StartCustomTimestampFormat, kPatternLogFileName);
+            auto& state = m_state->categories[i];
 
+            // File Sink, routes of all categories are added to it after loop
             const auto fileLogLevel = m_loggerSinks[i].logLevels[SinksLogLevel::LogSources::File];
-
-            auto fileSink = quill::Frontend::create_or_get_sink<quill::FileSink>(kLogSettingsFileName.data(), std::move(cfg));
-            fileSink->set_log_level_filter(
-                getLogLevelByShortName(SinksLogLevel::LogLevels::toString(fileLogLevel.currentLogLevel)));
+            state.routes[SinksLogLevel::LogSources::File].logLevel.store(
+                getLogLevelByShortName(SinksLogLevel::LogLevels::toString(fileLogLevel.currentLogLevel)),
+                std::memory_order_relaxed);
 
             // Console Sink
             quill::ConsoleSinkConfig consoleCfg;
@@ -61,203 +175,1480 @@ public:
 
             const auto consoleLogLevel = m_loggerSinks[i].logLevels[SinksLogLevel::LogSources::Console];
 
-            auto consoleSink =
-                quill::Frontend::create_or_get_sink<quill::ConsoleSink>(Category::toString(i).data(), std::move(consoleCfg));
-            consoleSink->set_log_level_filter(
-                getLogLevelByShortName(SinksLogLevel::LogLevels::toString(consoleLogLevel.currentLogLevel)));
+            const auto loggerName = getLoggerName(Tree::getName(i));
+
+            auto consoleSink = logger::Frontend::create_or_get_sink<ConsoleSink>(loggerName, std::move(consoleCfg));
+            addSinkRoute<ConsoleSink>(consoleSink, loggerName, state.routes[SinksLogLevel::LogSources::Console],
+                consoleLogLevel.currentLogLevel);
+
+            // Messages are counted by level once per category, on file route
+            state.routes[SinksLogLevel::LogSources::File].category = &state.counters;
 
             // Logger create
-            m_loggers[i] =
-                quill::Frontend::create_or_get_logger(Category::toString(i).data(), {std::move(fileSink), std::move(consoleSink)},
-                    quill::PatternFormatterOptions{getPatternFormatter().data(), kPatternFormatterTime.data()});
-            m_loggers[i]->init_backtrace(BacktraceLength, quill::LogLevel::Critical);
-            m_loggers[i]->set_log_level(quill::LogLevel::TraceL3);
+            m_loggers[i] = logger::Frontend::create_or_get_logger(loggerName, {fileSink, std::move(consoleSink), traceSink},
+                quill::PatternFormatterOptions{getPatternFormatter(Tree::getName(i)), kPatternFormatterTime.data()});
+
+            updateLoggerLogLevel(i);
+        }
+        addFileRoutes(fileSink);
+
+        createInternalLogger();
+        registerModule();
+        reportBacktraceCapacity();
+        m_startupProfile.sinksNs = getElapsedNs(sinksStart, std::chrono::steady_clock::now());
+
+        if (options.startBackend)
+        {
+            startBackend();
+        }
+    }
+
+    ~CategorizedLogger()
+    {
+        getModuleRegistry().removeModule(this);
+    }
+
+    CategorizedLogger(const CategorizedLogger&)            = delete;
+    CategorizedLogger& operator=(const CategorizedLogger&) = delete;
+
+    // Backend is process wide, it is started by first logger module which starts it, with [Backend] settings of that
+    // module. Later modules use running backend
+    void startBackend()
+    {
+        const auto backendStart = std::chrono::steady_clock::now();
+
+        auto& registry = getModuleRegistry();
+        if (!registry.isBackendStarted())
+        {
+            quill::BackendOptions backendOptions;
+            backendOptions.error_notifier = onBackendNotification;
+            placeBackendOnNumaNode(backendOptions);
+            registry.startBackend(kLoggerName, backendOptions);
+        }
+        m_backendStarted = true;
+
+        m_startupProfile.backendStartNs = getElapsedNs(backendStart, std::chrono::steady_clock::now());
+    }
+
+    const StartupProfile& getStartupProfile() const noexcept
+    {
+        return m_startupProfile;
+    }
+
+    bool isBackendStarted() const noexcept
+    {
+        return m_backendStarted;
+    }
+
+    // Settings are read by constructor, so options of lazy module init() called after module was created by its
+    // first message can't be applied. Settings file of such call is reported as error
+    void reportIgnoredInitOptions(const InitOptions& options)
+    {
+        if (options.settingsFileName != m_settingsFileName)
+        {
+            QUILL_LOG_ERROR(m_state->internalLogger, "{}: module was created with settings file {} before init(), {} is ignored",
+                kLoggerName, m_settingsFileName, options.settingsFileName);
         }
+    }
 
-        quill::Backend::start();
+    static constexpr std::string_view getName()
+    {
+        return kLoggerName;
+    }
+
+    static constexpr size_t getCategoriesCount()
+    {
+        return Category::getSize();
     }
 
-    quill::Logger* getLogger(const BaseCategory name)
+    logger::Logger* getLogger(const BaseCategory name)
     {
         return m_loggers[name];
     }
 
-    quill::Logger* getFirstLoggerOrNullptr()
+    // Sample rate from "SampleRate" setting of category, used by CAT_LOG_*_SAMPLE_DEFAULT
+    double getSampleRate(const BaseCategory name) const noexcept
+    {
+        return m_categorySettings[name].sampleRate;
+    }
+
+    uint64_t getSampleThreshold(const BaseCategory name) const noexcept
+    {
+        return m_sampleThresholds[name];
+    }
+
+    // Backtrace storage is allocated on first CAT_LOG_BACKTRACE of category. False if backtrace of category is disabled
+    bool initBacktrace(const BaseCategory name)
+    {
+        const auto& backtrace = m_backtraceSettings[name];
+        if (backtrace.length == 0)
+        {
+            return false;
+        }
+
+        // Other threads wait until backtrace is initialized, so their messages are not stored before it
+        std::call_once(m_backtraceInitFlags[name],
+            [&]() { m_loggers[name]->init_backtrace(backtrace.length, backtrace.flushLevel); });
+        return true;
+    }
+
+    // Level of category logger is lowest level of its sinks, so it tells if any sink writes message of level
+    bool isEnabled(const BaseCategory name, quill::LogLevel logLevel) const noexcept
+    {
+        return m_loggers[name]->should_log_statement(logLevel);
+    }
+
+    // False if message passes category level, but exceeds category rate limit or queue memory budget. Used by logging
+    // defines before encoding, task context of thread is sent to backend here if it was switched
+    bool canEnqueue(const BaseCategory name, quill::LogLevel logLevel) noexcept
+    {
+        auto* logger = m_loggers[name];
+        if (!logger->should_log_statement(logLevel))
+        {
+            return true;
+        }
+
+        auto* rateLimiter = m_rateLimiters[name];
+        if (rateLimiter != nullptr && !rateLimiter->tryAcquire(logLevel))
+        {
+            return false;
+        }
+        if (!acquireQueueBudget())
+        {
+            return false;
+        }
+
+        detail::syncTaskContext();
+        return true;
+    }
+
+    // Prepares calling thread for logging, so its first message costs the same as any other. Called before latency
+    // sensitive work of thread
+    void warmUpThisThread(WarmUpOptions options = {})
+    {
+        if (options.prefaultQueue)
+        {
+            prefaultThisThreadQueue();
+        }
+        else
+        {
+            logger::Frontend::preallocate();
+        }
+
+        for (auto* categoryLogger : m_loggers)
+        {
+            const auto logLevel = categoryLogger->get_log_level();
+            if (options.encodeCategoryMessages && logLevel < quill::LogLevel::Backtrace)
+            {
+                QUILL_LOG_DYNAMIC(categoryLogger, logLevel, "Thread warm up");
+            }
+        }
+
+        // Thread local state used by logging defines
+        getThreadQueueAccount();
+        getSampleRandom();
+    }
+
+    // Thread pools call it from each new worker thread before it takes tasks
+    std::function<void()> getThreadStartHook(WarmUpOptions options = {})
+    {
+        return [this, options]() { warmUpThisThread(options); };
+    }
+
+    // Runtime level of sink of category, settings file is not changed
+    void setLogLevel(const BaseCategory name, LogSink sink, quill::LogLevel logLevel)
+    {
+        setRouteLogLevel(m_state->categories[name], m_loggers[name], sink, logLevel);
+    }
+
+    // Category added at runtime, e.g. by plugin. Its levels are read from "[<Module>.<Name>]" section of settings file,
+    // section with levels from options is added if it is missing. Registering same name again returns same handle.
+    // Empty handle if name is taken by static category or all kMaxDynamicCategories are registered
+    DynamicCategory registerCategory(std::string_view name, DynamicCategoryOptions options = {})
+    {
+        std::lock_guard lock(m_dynamicCategoriesMutex);
+
+        auto category = findCategory(name);
+        if (category || Tree::find(name) || kCategoryNames<Category>.find(name))
+        {
+            return category;
+        }
+
+        auto* state = m_state->dynamicCategories.append([&](DynamicCategoryState& newCategory)
+            { initDynamicCategory(newCategory, name, options); });
+        if (state == nullptr)
+        {
+            QUILL_LOG_WARNING(m_state->internalLogger, "{}: category {} is not registered, limit of {} dynamic categories is reached",
+                kLoggerName, name, kMaxDynamicCategories);
+        }
+        return DynamicCategory(state);
+    }
+
+    // Lock free, so plugins may look up categories registered by other code. Handle is stable, it is cached by caller
+    DynamicCategory findCategory(std::string_view name)
+    {
+        return DynamicCategory(findDynamicCategory(name));
+    }
+
+    // Budget is process wide and shared with other logger modules
+    void setQueueMemoryBudget(size_t bytes, QueueBudgetPolicy policy) noexcept
+    {
+        logger::setQueueMemoryBudget(bytes, policy);
+    }
+
+    logger::Logger* getFirstLoggerOrNullptr()
     {
         return m_loggers.empty() ? nullptr : m_loggers.front();
     }
 
-private:
-    static quill::LogLevel getLogLevelByShortName(std::string_view logLevel)
+    LoggerStats<Category::getSize()> getStats() const
     {
-        quill::BackendOptions opt;
-        auto* it = std::ranges::find(opt.log_level_short_codes, logLevel);
-        if (it == opt.log_level_short_codes.end())
+        LoggerStats<Category::getSize()> stats;
+        for (BaseCategory i = 0; i < Category::getSize(); ++i)
         {
-            return quill::LogLevel::Info;
+            stats.categories[i] = getCategoryStats(Tree::getName(i), m_state->categories[i]);
         }
-        return static_cast<quill::LogLevel>(std::distance(opt.log_level_short_codes.begin(), it));
+        stats.queues = getQueueStats();
+        return stats;
     }
 
-    void loadSettings()
+    std::vector<CategoryStats> getDynamicCategoryStats() const
     {
-        CSimpleIniA loggerSettingsFile;
-        loggerSettingsFile.LoadFile(kLoggerSettingsFileName.data());
+        const auto& dynamicCategories = m_state->dynamicCategories;
 
-        quill::BackendOptions opt;
-        static_assert(opt.log_level_descriptions.size() == opt.log_level_short_codes.size());
-        for (uint32_t i = 0; i < opt.log_level_short_codes.size(); ++i)
+        std::vector<CategoryStats> stats(dynamicCategories.size());
+        for (size_t i = 0; i < stats.size(); ++i)
         {
-            loggerSettingsFile.SetValue("Description", opt.log_level_descriptions[i].data(), opt.log_level_short_codes[i].data());
+            stats[i] = getCategoryStats(dynamicCategories[i].name, dynamicCategories[i].state);
         }
+        return stats;
+    }
 
+    std::array<CategoryLatencyStats, Category::getSize()> getLatencyStats() const
+    {
+        std::array<CategoryLatencyStats, Category::getSize()> stats;
         for (BaseCategory i = 0; i < Category::getSize(); ++i)
         {
-            for (auto& sink : m_loggerSinks[i].logLevels)
-            {
-                const auto logSource = SinksLogLevel::LogSources::toString(sink.first);
-                const auto logLevel  = SinksLogLevel::LogLevels::toString(sink.second.currentLogLevel);
+            stats[i] = getCategoryLatencyStats(Tree::getName(i), m_state->categories[i]);
+        }
+        return stats;
+    }
 
-                const auto levelFromSettings =
-                    loggerSettingsFile.GetValue(Category::toString(i).data(), logSource.data(), logLevel.data());
+    std::vector<CategoryLatencyStats> getDynamicCategoryLatencyStats() const
+    {
+        const auto& dynamicCategories = m_state->dynamicCategories;
 
-                const bool result = SinksLogLevel::LogLevels::fromString(levelFromSettings, sink.second.currentLogLevel);
-                if (!result)
-                {
-                    sink.second.currentLogLevel = sink.second.defaultLogLevel;
-                }
+        std::vector<CategoryLatencyStats> stats(dynamicCategories.size());
+        for (size_t i = 0; i < stats.size(); ++i)
+        {
+            stats[i] = getCategoryLatencyStats(dynamicCategories[i].name, dynamicCategories[i].state);
+        }
+        return stats;
+    }
 
-                const auto newLogLevel = SinksLogLevel::LogLevels::toString(sink.second.currentLogLevel);
-                loggerSettingsFile.SetValue(Category::toString(i).data(), logSource.data(), newLogLevel.data());
-            }
+    // Writes scope timing events of all categories in Chrome JSON trace format. Zero duration captures until stop
+    bool startTraceCapture(const std::filesystem::path& path, std::chrono::nanoseconds duration = {})
+    {
+        return m_traceSink->start(path, duration);
+    }
+
+    void stopTraceCapture()
+    {
+        m_traceSink->stop();
+    }
+
+    // Latency percentiles of each category are written periodically by "Internal" logger. Zero interval disables it
+    void setLatencyDumpInterval(std::chrono::milliseconds interval)
+    {
+        setReportInterval(m_latencyDumpTask, [state = m_state]() { dumpLatencyStats(*state); }, interval);
+    }
+
+    // Busiest log statements of all categories by messages per second since start
+    std::vector<CallSiteStats> getTopCallSites(size_t count = kDefaultCallSitesCount) const
+    {
+        std::vector<CallSiteStats> callSites;
+        for (BaseCategory i = 0; i < Category::getSize(); ++i)
+        {
+            auto categoryCallSites = m_state->categories[i].counters.callSites.getTop(Tree::getName(i), count);
+            callSites.insert(callSites.end(), categoryCallSites.begin(), categoryCallSites.end());
         }
+        CallSiteProfiler::keepTop(callSites, count);
+        return callSites;
+    }
 
-        loggerSettingsFile.SaveFile(kLoggerSettingsFileName.data());
+    // Busiest log statements of last interval are written periodically by "Internal" logger. Zero interval disables it
+    void setCallSiteDumpInterval(std::chrono::milliseconds interval, size_t count = kDefaultCallSitesCount)
+    {
+        m_state->callSiteDumpCount.store(count, std::memory_order_relaxed);
+        setReportInterval(m_callSiteDumpTask, [state = m_state]() { dumpCallSiteStats(*state); }, interval);
+    }
+
+private:
+    // Report task is added to reporter when report is enabled first time, so reporter thread doesn't run for
+    // modules without reports
+    void setReportInterval(std::optional<PeriodicReporter::TaskId>& reportTask, PeriodicReporter::Task report,
+        std::chrono::nanoseconds interval)
+    {
+        std::lock_guard lock(m_reportTasksMutex);
+        if (reportTask.has_value())
+        {
+            getPeriodicReporter().setTaskInterval(*reportTask, interval);
+        }
+        else if (interval.count() != 0)
+        {
+            reportTask = getPeriodicReporter().addTask(std::move(report), interval);
+        }
     }
 
-    template <size_t number>
-    static consteval auto getNumberAsCharArray()
+    template <class TSink>
+    void addSinkRoute(const std::shared_ptr<quill::Sink>& sink, std::string_view category, SinkRoute& route,
+        typename SinksLogLevel::LogLevel logLevel)
     {
-        constexpr uint8_t kOneDecimalDigit = 10;
+        route.logLevel.store(getLogLevelByShortName(SinksLogLevel::LogLevels::toString(logLevel)), std::memory_order_relaxed);
 
-        constexpr auto countDigits = [kOneDecimalDigit](size_t x) constexpr
+        // Sink with same name could be created before by other code with other type, then it is left unobserved
+        auto* observedSink = dynamic_cast<TSink*>(sink.get());
+        if (observedSink != nullptr)
         {
-            int len = (x <= 0) ? 1 : 0;
-            while (x)
-            {
-                x /= kOneDecimalDigit;
-                ++len;
-            }
-            return len;
-        };
+            observedSink->getRouter().addRoute(category, &route, m_state);
+        }
+    }
 
-        constexpr int len = countDigits(number);
-        std::array<char, len> result{};
+    // Log file sink is shared by all categories and modules
+    void addFileRoutes(const std::shared_ptr<quill::Sink>& fileSink)
+    {
+        auto* observedSink = dynamic_cast<FileSink*>(fileSink.get());
+        if (observedSink == nullptr)
+        {
+            return;
+        }
 
-        auto num = number;
-        for (int i = len - 1; i >= 0; --i)
+        std::array<std::string, Category::getSize()> loggerNames;
+        std::array<SinkRouter::NamedRoute, Category::getSize()> routes;
+        for (BaseCategory i = 0; i < Category::getSize(); ++i)
         {
-            result[i]  = '0' + (num % kOneDecimalDigit);
-            num       /= kOneDecimalDigit;
+            loggerNames[i] = getLoggerName(Tree::getName(i));
+            routes[i]      = {loggerNames[i], &m_state->categories[i].routes[SinksLogLevel::LogSources::File]};
         }
+        observedSink->getRouter().addRoutes(routes, m_state);
+    }
 
-        return result;
+    // Messages below level of both sinks are dropped on caller side before encoding
+    void updateLoggerLogLevel(BaseCategory category)
+    {
+        updateLoggerLogLevel(m_state->categories[category], m_loggers[category]);
+    }
+
+    static void updateLoggerLogLevel(const CategoryState& state, logger::Logger* categoryLogger)
+    {
+        const auto& routes = state.routes;
+        categoryLogger->set_log_level(std::min(routes[SinksLogLevel::LogSources::File].logLevel.load(),
+            routes[SinksLogLevel::LogSources::Console].logLevel.load()));
+    }
+
+    static void setRouteLogLevel(CategoryState& state, logger::Logger* categoryLogger, LogSink sink, quill::LogLevel logLevel)
+    {
+        const auto logSource = sink == LogSink::File ? SinksLogLevel::LogSources::File : SinksLogLevel::LogSources::Console;
+        state.routes[logSource].logLevel.store(logLevel, std::memory_order_relaxed);
+        updateLoggerLogLevel(state, categoryLogger);
+    }
+
+    static CategoryStats getCategoryStats(std::string_view name, const CategoryState& state)
+    {
+        CategoryStats stats;
+        stats.name = name;
+        for (size_t level = 0; level < kLogLevelsCount; ++level)
+        {
+            stats.messagesByLevel[level] = state.counters.messagesByLevel[level].load(std::memory_order_relaxed);
+        }
+        stats.file    = state.routes[SinksLogLevel::LogSources::File].counters.load();
+        stats.console = state.routes[SinksLogLevel::LogSources::Console].counters.load();
+        return stats;
+    }
+
+    DynamicCategoryState* findDynamicCategory(std::string_view name)
+    {
+        auto& dynamicCategories = m_state->dynamicCategories;
+        for (size_t i = 0; i < dynamicCategories.size(); ++i)
+        {
+            if (dynamicCategories[i].name == name)
+            {
+                return &dynamicCategories[i];
+            }
+        }
+        return nullptr;
     }
 
-    static consteval auto getPatternFormatter()
+    // Called under m_dynamicCategoriesMutex, before category is visible to other threads
+    void initDynamicCategory(DynamicCategoryState& category, std::string_view name, const DynamicCategoryOptions& options)
     {
-        // "+ 2" for whitespaces in begin and end
-        constexpr auto size = Category::maxSourceStringLength() + 2;
+        category.name = name;
+
+        auto& logLevels = category.sinks.logLevels;
+        for (const auto& [logSource, logLevel] : {std::pair{SinksLogLevel::LogSources::File, options.fileLogLevel},
+                 std::pair{SinksLogLevel::LogSources::Console, options.consoleLogLevel}})
+        {
+            logLevels[logSource].currentLogLevel = getShortLogLevel(logLevel);
+            logLevels[logSource].defaultLogLevel = logLevels[logSource].currentLogLevel;
+        }
+
+        // Section of category is known to settings functions before category is published
+        ++m_dynamicSectionsCount;
+        const auto section = getSectionsCount() - 1;
+        getModuleRegistry().updateSettings(m_settingsFileName,
+            [this, section](std::string_view content) { return applyDynamicCategorySettings(content, section); });
+
+        const auto loggerName = getLoggerName(category.name);
 
-        // "+ 1" for null-terminated
-        std::array<char, kPatternFormatterLogsPart1.size() + kLoggerName.size() + kPatternFormatterLogsPart2.size() + size +
-                             kPatternFormatterLogsPart3.size() + 1>
-            res{};
+        auto& routes  = category.state.routes;
+        auto fileSink = getModuleRegistry().getFileSink();
+        addSinkRoute<FileSink>(fileSink, loggerName, routes[SinksLogLevel::LogSources::File],
+            logLevels[SinksLogLevel::LogSources::File].currentLogLevel);
 
-        constexpr auto loggerNameLength = getNumberAsCharArray<size>();
+        quill::ConsoleSinkConfig consoleCfg;
+        consoleCfg.set_colour_mode(quill::ConsoleSinkConfig::ColourMode::Always);
 
-        auto* ptr = res.data();
-        ptr       = std::copy(kPatternFormatterLogsPart1.begin(), kPatternFormatterLogsPart1.end(), ptr);
-        ptr       = std::copy(kLoggerName.begin(), kLoggerName.end(), ptr);
-        ptr       = std::copy(kPatternFormatterLogsPart2.begin(), kPatternFormatterLogsPart2.end(), ptr);
-        ptr       = std::copy(std::begin(loggerNameLength), std::end(loggerNameLength), ptr);
-        ptr       = std::copy(kPatternFormatterLogsPart3.begin(), kPatternFormatterLogsPart3.end(), ptr);
+        auto consoleSink = logger::Frontend::create_or_get_sink<ConsoleSink>(loggerName, std::move(consoleCfg));
+        addSinkRoute<ConsoleSink>(consoleSink, loggerName, routes[SinksLogLevel::LogSources::Console],
+            logLevels[SinksLogLevel::LogSources::Console].currentLogLevel);
 
-        return res;
+        routes[SinksLogLevel::LogSources::File].category = &category.state.counters;
+
+        category.logger = logger::Frontend::create_or_get_logger(loggerName,
+            {std::move(fileSink), std::move(consoleSink), m_traceSink},
+            quill::PatternFormatterOptions{getPatternFormatter(category.name), kPatternFormatterTime.data()});
+        updateLoggerLogLevel(category.state, category.logger);
     }
 
-    static constexpr std::string_view kLoggerSettingsFileName = "LogSettings.ini";
+    void registerModule()
+    {
+        ModuleEntry entry;
+        entry.module   = this;
+        entry.name     = kLoggerName;
+        entry.getStats = [this]()
+        {
+            const auto stats     = getStats();
+            const auto latencies = getLatencyStats();
 
-    static constexpr std::string_view kPatternLogFileName   = "_%d_%m_%Y_%H_%M_%S";
-    static constexpr std::string_view kLogSettingsFileName  = "logs/log.txt";
-    static constexpr std::string_view kPatternFormatterTime = "%H:%M:%S.%Qns";
+            ModuleStats moduleStats{kLoggerName, {stats.categories.begin(), stats.categories.end()},
+                {latencies.begin(), latencies.end()}};
+            const auto dynamicStats     = getDynamicCategoryStats();
+            const auto dynamicLatencies = getDynamicCategoryLatencyStats();
+            moduleStats.categories.insert(moduleStats.categories.end(), dynamicStats.begin(), dynamicStats.end());
+            moduleStats.latencies.insert(moduleStats.latencies.end(), dynamicLatencies.begin(), dynamicLatencies.end());
+            return moduleStats;
+        };
+        // Level of parent is set to all its child categories
+        entry.setLogLevel = [this](std::string_view category, LogSink sink, quill::LogLevel logLevel)
+        {
+            auto node = Tree::find(category);
+            node      = node ? node : kCategoryNames<Category>.find(category);
+            if (node)
+            {
+                for (BaseCategory i = 0; i < Category::getSize(); ++i)
+                {
+                    if (i == *node || Tree::isAncestor(*node, i))
+                    {
+                        setLogLevel(i, sink, logLevel);
+                    }
+                }
+                return true;
+            }
 
-    static constexpr std::string_view kPatternFormatterLogsPart1 =
-        "[%(time)] [%(thread_id)] [%(short_source_location:^28)] [%(log_level:^11)] [ ";
-    static constexpr std::string_view kPatternFormatterLogsPart2 = " ] [%(logger:^";
-    static constexpr std::string_view kPatternFormatterLogsPart3 = ")] %(message)";
+            auto* dynamicCategory = findDynamicCategory(category);
+            if (dynamicCategory != nullptr)
+            {
+                setRouteLogLevel(dynamicCategory->state, dynamicCategory->logger, sink, logLevel);
+            }
+            return dynamicCategory != nullptr;
+        };
+        getModuleRegistry().addModule(std::move(entry));
+    }
 
-    static constexpr std::string_view kLoggerName = LoggerName;
+    static uint64_t getElapsedNs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
 
-    std::array<quill::Logger*, Category::getSize()> m_loggers;
-    std::array<SinksLogLevel, Category::getSize()> m_loggerSinks;
-};
-}  // namespace logger
+    // Backend is pinned to last CPU of node, so queues of producers on that node are drained without crossing sockets.
+    // Backend is process wide, so only first started logger module places it
+    void placeBackendOnNumaNode(quill::BackendOptions& backendOptions) const
+    {
+        if (m_backendNumaNode < 0)
+        {
+            return;
+        }
 
-// clang-format off
-#define DEFINE_CAT_LOGGER_MODULE(Name, CategoryType, BacktraceLength)                                      \
-    extern const char s_##Name##LoggerName[];                                                              \
-    extern logger::CategorizedLogger<CategoryType, s_##Name##LoggerName, BacktraceLength> s_##Name##Logger
+        const auto cpus = getNumaNodeCpus(m_backendNumaNode);
+        if (cpus.empty())
+        {
+            QUILL_LOG_WARNING(m_state->internalLogger, "{} backend: NUMA node {} has no CPUs, backend is not pinned",
+                kLoggerName, m_backendNumaNode);
+            return;
+        }
 
-#define DEFINE_CAT_LOGGER_MODULE_INITIALIZATION(Name, CategoryType, BacktraceLength)                \
-    inline constexpr char s_##Name##LoggerName[] = #Name;                                           \
-    logger::CategorizedLogger<CategoryType, s_##Name##LoggerName, BacktraceLength> s_##Name##Logger
+        backendOptions.cpu_affinity = cpus.back();
+        QUILL_LOG_INFO(m_state->internalLogger, "{} backend: pinned to CPU {} of NUMA node {}", kLoggerName,
+            backendOptions.cpu_affinity, m_backendNumaNode);
+    }
 
-#define GET_LOGGER(LoggerName, name, catName) logger::s_##LoggerName##Logger.getLogger(logger::catName::name)
+    void reportBacktraceCapacity() const
+    {
+        constexpr size_t kBytesInKiB = 1024;
 
-// LOG_INFO
-#define CAT_LOG_TRACE_L3(logName, catName, cat, message, ...)  QUILL_LOG_TRACE_L3(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_TRACE_L2(logName, catName, cat, message, ...)  QUILL_LOG_TRACE_L2(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_TRACE_L1(logName, catName, cat, message, ...)  QUILL_LOG_TRACE_L1(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_DEBUG(logName, catName, cat, message, ...)     QUILL_LOG_DEBUG(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_INFO(logName, catName, cat, message, ...)      QUILL_LOG_INFO(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_NOTICE(logName, catName, cat, message, ...)    QUILL_LOG_NOTICE(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_WARNING(logName, catName, cat, message, ...)   QUILL_LOG_WARNING(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_ERROR(logName, catName, cat, message, ...)     QUILL_LOG_ERROR(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_CRITICAL(logName, catName, cat, message, ...)  QUILL_LOG_CRITICAL(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_BACKTRACE(logName, catName, cat, message, ...) QUILL_LOG_BACKTRACE(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
+        size_t categoriesCount = 0;
+        size_t messagesCount   = 0;
+        for (const auto& backtrace : m_backtraceSettings)
+        {
+            categoriesCount += backtrace.length != 0 ? 1 : 0;
+            messagesCount += backtrace.length;
+        }
 
-// LOGV_INFO
-#define CAT_LOGV_TRACE_L3(logName, catName, cat, message, ...)  QUILL_LOGV_TRACE_L3(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_TRACE_L2(logName, catName, cat, message, ...)  QUILL_LOGV_TRACE_L2(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_TRACE_L1(logName, catName, cat, message, ...)  QUILL_LOGV_TRACE_L1(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_DEBUG(logName, catName, cat, message, ...)     QUILL_LOGV_DEBUG(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_INFO(logName, catName, cat, message, ...)      QUILL_LOGV_INFO(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_NOTICE(logName, catName, cat, message, ...)    QUILL_LOGV_NOTICE(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_WARNING(logName, catName, cat, message, ...)   QUILL_LOGV_WARNING(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_ERROR(logName, catName, cat, message, ...)     QUILL_LOGV_ERROR(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_CRITICAL(logName, catName, cat, message, ...)  QUILL_LOGV_CRITICAL(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOGV_BACKTRACE(logName, catName, cat, message, ...) QUILL_LOGV_BACKTRACE(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
+        // Stored messages longer than inline buffer of transit event take more
+        QUILL_LOG_INFO(m_state->internalLogger,
+            "{} backtrace: up to {} messages in {} categories, at least {} KiB if all are filled. Allocated on first use",
+            kLoggerName, messagesCount, categoriesCount, messagesCount * sizeof(quill::detail::TransitEvent) / kBytesInKiB);
+    }
 
-// LOG_INFO_LIMIT
-#define CAT_LOG_TRACE_L3_LIMIT_TIME(logName, catName, cat, time, message, ...) QUILL_LOG_TRACE_L3_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_TRACE_L2_LIMIT_TIME(logName, catName, cat, time, message, ...) QUILL_LOG_TRACE_L2_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_TRACE_L1_LIMIT_TIME(logName, catName, cat, time, message, ...) QUILL_LOG_TRACE_L1_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_DEBUG_LIMIT_TIME(logName, catName, cat, time, message, ...)    QUILL_LOG_DEBUG_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_INFO_LIMIT_TIME(logName, catName, cat, time, message, ...)     QUILL_LOG_INFO_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_NOTICE_LIMIT_TIME(logName, catName, cat, time, message, ...)   QUILL_LOG_NOTICE_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_WARNING_LIMIT_TIME(logName, catName, cat, time, message, ...)  QUILL_LOG_WARNING_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_ERROR_LIMIT_TIME(logName, catName, cat, time, message, ...)    QUILL_LOG_ERROR_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_CRITICAL_LIMIT_TIME(logName, catName, cat, time, message, ...) QUILL_LOG_CRITICAL_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
+    void createInternalLogger()
+    {
+        auto fileSink = getModuleRegistry().getFileSink();
 
-// LOG_INFO_LIMIT_EVERY_N
-#define CAT_LOG_TRACE_L3_LIMIT_EVERY_N(logName, catName, cat, count, message, ...) QUILL_LOG_TRACE_L3_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_TRACE_L2_LIMIT_EVERY_N(logName, catName, cat, count, message, ...) QUILL_LOG_TRACE_L2_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_TRACE_L1_LIMIT_EVERY_N(logName, catName, cat, count, message, ...) QUILL_LOG_TRACE_L1_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_DEBUG_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)    QUILL_LOG_DEBUG_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_INFO_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)     QUILL_LOG_INFO_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_NOTICE_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)   QUILL_LOG_NOTICE_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_WARNING_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)  QUILL_LOG_WARNING_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_ERROR_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)    QUILL_LOG_ERROR_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
-#define CAT_LOG_CRITICAL_LIMIT_EVERY_N(logName, catName, cat, count, message, ...) QUILL_LOG_CRITICAL_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__)
+        // Backend thread can't log, so reports are logged by reporter thread. Rate limiters are created only from
+        // settings, which are read before
+        if (std::ranges::any_of(m_state->rateLimiters, [](const auto& rateLimiter) { return rateLimiter != nullptr; }))
+        {
+            getPeriodicReporter().addTask([state = m_state]() { reportSuppressedMessages(*state); }, kRateLimitReportInterval);
+        }
+
+        m_state->internalLogger = logger::Frontend::create_or_get_logger(getLoggerName(kInternalLoggerName), std::move(fileSink),
+            quill::PatternFormatterOptions{getPatternFormatter(kInternalLoggerName), kPatternFormatterTime.data()});
+    }
+
+    static CategoryLatencyStats getCategoryLatencyStats(std::string_view name, const CategoryState& state)
+    {
+        return CategoryLatencyStats{name, state.counters.queueLatency.load(),
+            state.routes[SinksLogLevel::LogSources::File].writeLatency.load(),
+            state.routes[SinksLogLevel::LogSources::Console].writeLatency.load()};
+    }
+
+    // Called by reporter thread
+    static void reportSuppressedMessages(ModuleState& state)
+    {
+        const auto now     = std::chrono::steady_clock::now();
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(now - state.lastRateLimitReport).count();
+        state.lastRateLimitReport = now;
+
+        for (BaseCategory i = 0; i < Category::getSize(); ++i)
+        {
+            if (state.rateLimiters[i] == nullptr)
+            {
+                continue;
+            }
+
+            const auto suppressed = state.rateLimiters[i]->takeSuppressed();
+            if (suppressed != 0)
+            {
+                QUILL_LOG_WARNING(state.internalLogger, "{}: suppressed {} messages in last {}s", Tree::getName(i),
+                    suppressed, seconds);
+            }
+        }
+    }
+
+    // Called by reporter thread
+    static void dumpLatencyStats(ModuleState& state)
+    {
+        constexpr double kMedian       = 50.0;
+        constexpr double kPercentile99 = 99.0;
+
+        for (BaseCategory i = 0; i < Category::getSize(); ++i)
+        {
+            const auto stats = getCategoryLatencyStats(Tree::getName(i), state.categories[i]);
+            if (stats.queue.count == 0)
+            {
+                continue;
+            }
+
+            QUILL_LOG_INFO(state.internalLogger,
+                "{}.{} latency ns: queue p50={} p99={} max={} | file write p50={} p99={} | console write p50={} p99={}",
+                kLoggerName, stats.name, stats.queue.getPercentile(kMedian), stats.queue.getPercentile(kPercentile99),
+                stats.queue.max, stats.fileWrite.getPercentile(kMedian), stats.fileWrite.getPercentile(kPercentile99),
+                stats.consoleWrite.getPercentile(kMedian), stats.consoleWrite.getPercentile(kPercentile99));
+        }
+    }
+
+    // Called by reporter thread
+    static void dumpCallSiteStats(ModuleState& state)
+    {
+        const auto count = state.callSiteDumpCount.load(std::memory_order_relaxed);
+
+        std::vector<CallSiteStats> callSites;
+        for (BaseCategory i = 0; i < Category::getSize(); ++i)
+        {
+            auto categoryCallSites = state.categories[i].counters.callSites.takeIntervalTop(Tree::getName(i), count);
+            callSites.insert(callSites.end(), categoryCallSites.begin(), categoryCallSites.end());
+        }
+        CallSiteProfiler::keepTop(callSites, count);
+
+        for (const auto& callSite : callSites)
+        {
+            QUILL_LOG_INFO(state.internalLogger, "{}.{} {} msg/s {} B/s at {} in {}: \"{}\"", kLoggerName, callSite.category,
+                static_cast<uint64_t>(callSite.messagesPerSecond), static_cast<uint64_t>(callSite.bytesPerSecond),
+                callSite.sourceLocation, callSite.function, callSite.format);
+        }
+    }
+
+    static typename SinksLogLevel::LogLevel getShortLogLevel(quill::LogLevel logLevel)
+    {
+        typename SinksLogLevel::LogLevel result = SinksLogLevel::LogLevels::I;
+        SinksLogLevel::LogLevels::fromString(getDefaultBackendOptions().log_level_short_codes[static_cast<size_t>(logLevel)], result);
+        return result;
+    }
+
+    static quill::LogLevel getLogLevelByShortName(std::string_view logLevel)
+    {
+        const auto& opt = getDefaultBackendOptions();
+        const auto it   = std::ranges::find(opt.log_level_short_codes, logLevel);
+        if (it == opt.log_level_short_codes.end())
+        {
+            return quill::LogLevel::Info;
+        }
+        return static_cast<quill::LogLevel>(std::distance(opt.log_level_short_codes.begin(), it));
+    }
+
+    // Settings file is read once per process by module registry. Settings of module are parsed in one pass and applied
+    // directly, file is rewritten only when some setting is missing or not in canonical form
+    void loadSettings()
+    {
+        getModuleRegistry().updateSettings(m_settingsFileName, [this](std::string_view content) { return applySettings(content); });
+    }
+
+    // Returns new content of settings file, empty if it is up to date
+    std::string applySettings(std::string_view content)
+    {
+        std::array<std::bitset<kMaxSectionKeys>, kSectionsCount> appliedKeys{};
+        bool isCanonical = true;
+
+        // Sections of files written by older versions, see findLegacyCategory. Used for keys missing in
+        // "[<Module>.<Category>]" section, which is then added to file
+        std::array<std::bitset<kMaxSectionKeys>, Category::getSize()> legacyKeys{};
+        std::optional<size_t> legacyCategory;
+
+        std::optional<size_t> section;
+        forEachSettingsLine(content,
+            [&](const SettingsLine& line)
+            {
+                if (line.type == SettingsLine::Type::Section)
+                {
+                    section        = findSection(line.name);
+                    legacyCategory = section ? std::nullopt : findLegacyCategory(line.name);
+                    return;
+                }
+
+                if (line.type != SettingsLine::Type::Value)
+                {
+                    return;
+                }
+
+                if (legacyCategory)
+                {
+                    const auto legacySection = kCategorySectionsOffset + *legacyCategory;
+                    const auto key           = findKey(legacySection, line.name);
+                    if (key && !appliedKeys[legacySection].test(*key) && applySetting(legacySection, *key, line.value))
+                    {
+                        legacyKeys[*legacyCategory].set(*key);
+                    }
+                    return;
+                }
+
+                const auto key = section ? findKey(*section, line.name) : std::nullopt;
+                if (!key || !applySetting(*section, *key, line.value))
+                {
+                    return;
+                }
+                appliedKeys[*section].set(*key);
+
+                SettingsValueBuffer buffer;
+                isCanonical = isCanonical && formatSetting(*section, *key, buffer) == line.value;
+            });
+
+        inheritLogLevels(
+            [&](size_t node, size_t key)
+            {
+                return appliedKeys[kCategorySectionsOffset + node].test(key) || (Tree::isCategory(node) && legacyKeys[node].test(key));
+            });
+
+        for (BaseCategory i = 0; i < Category::getSize(); ++i)
+        {
+            const auto setKeys = appliedKeys[kCategorySectionsOffset + i] | legacyKeys[i];
+            applyCategorySettings(i, setKeys.test(CategorySettingsKeys::RateLimitBurst));
+        }
+
+        for (size_t i = 0; i < kSectionsCount && isCanonical; ++i)
+        {
+            for (size_t key = 0; key < getKeysCount(i); ++key)
+            {
+                isCanonical = isCanonical && (appliedKeys[i].test(key) || !isSettingWritten(i, key));
+            }
+        }
+
+        return isCanonical ? std::string() : makeNewSettingsContent(content);
+    }
+
+    // Levels missing in section of child are taken from nearest parent section which has them. Roots always have levels
+    template <class TIsSet>
+    void inheritLogLevels(TIsSet&& isSet)
+    {
+        for (size_t node = 0; node < Tree::kNodesCount; ++node)
+        {
+            for (const size_t key : {CategorySettingsKeys::Console, CategorySettingsKeys::File})
+            {
+                auto& logLevel       = m_loggerSinks[node].logLevels[getLogSource(key)];
+                logLevel.isInherited = !isSet(node, key) && Tree::getParent(node) != Tree::kNoParent;
+                if (!logLevel.isInherited)
+                {
+                    continue;
+                }
+
+                auto parent = Tree::getParent(node);
+                while (parent != Tree::kNoParent && !isSet(parent, key))
+                {
+                    parent = Tree::getParent(parent);
+                }
+                if (parent != Tree::kNoParent)
+                {
+                    logLevel.currentLogLevel = m_loggerSinks[parent].logLevels[getLogSource(key)].currentLogLevel;
+                }
+            }
+        }
+    }
+
+    // Same as applySettings for section of one dynamic category, other sections are already applied
+    std::string applyDynamicCategorySettings(std::string_view content, size_t section)
+    {
+        std::bitset<kMaxSectionKeys> appliedKeys;
+        bool isCanonical = true;
+
+        bool isInSection = false;
+        forEachSettingsLine(content,
+            [&](const SettingsLine& line)
+            {
+                if (line.type == SettingsLine::Type::Section)
+                {
+                    isInSection = findSection(line.name) == section;
+                    return;
+                }
+
+                const auto key = isInSection && line.type == SettingsLine::Type::Value ? findKey(section, line.name) : std::nullopt;
+                if (!key || !applySetting(section, *key, line.value))
+                {
+                    return;
+                }
+                appliedKeys.set(*key);
+
+                SettingsValueBuffer buffer;
+                isCanonical = isCanonical && formatSetting(section, *key, buffer) == line.value;
+            });
+
+        for (size_t key = 0; key < getKeysCount(section) && isCanonical; ++key)
+        {
+            isCanonical = appliedKeys.test(key) || !isSettingWritten(section, key);
+        }
+        return isCanonical ? std::string() : makeNewSettingsContent(content);
+    }
+
+    // Empty if content doesn't change
+    std::string makeNewSettingsContent(std::string_view content) const
+    {
+        auto newContent = makeSettingsContent(content);
+        if (newContent == content)
+        {
+            newContent.clear();
+        }
+        return newContent;
+    }
+
+    // Copy of content, where settings of module are in canonical form and missing sections are appended
+    std::string makeSettingsContent(std::string_view content) const
+    {
+        constexpr size_t kExpectedSectionSize = 256;
+
+        std::string result;
+        result.reserve(content.size() + kSectionsCount * kExpectedSectionSize);
+        if (content.starts_with(kUtf8Bom))
+        {
+            result += kUtf8Bom;
+        }
+
+        std::vector<bool> writtenSections(getSectionsCount());
+        std::optional<size_t> section;
+        forEachSettingsLine(content,
+            [&](const SettingsLine& line)
+            {
+                if (line.type == SettingsLine::Type::Value && section)
+                {
+                    const auto key = findKey(*section, line.name);
+                    if (key && isSettingWritten(*section, *key))
+                    {
+                        return;
+                    }
+                }
+
+                result += line.text;
+                result += '\n';
+
+                if (line.type == SettingsLine::Type::Section)
+                {
+                    section = findSection(line.name);
+                    if (section && !writtenSections[*section])
+                    {
+                        appendSettings(result, *section);
+                        writtenSections[*section] = true;
+                    }
+                }
+            });
+
+        for (size_t i = 0; i < writtenSections.size(); ++i)
+        {
+            if (writtenSections[i])
+            {
+                continue;
+            }
+
+            if (!result.empty() && !result.ends_with("\n\n"))
+            {
+                result += '\n';
+            }
+            result += '[';
+            appendSectionName(result, i);
+            result += "]\n";
+            appendSettings(result, i);
+        }
+        return result;
+    }
+
+    void appendSettings(std::string& result, size_t section) const
+    {
+        for (size_t key = 0; key < getKeysCount(section); ++key)
+        {
+            if (!isSettingWritten(section, key))
+            {
+                continue;
+            }
+
+            SettingsValueBuffer buffer;
+            result += getKeyName(section, key);
+            result += " = ";
+            result += formatSetting(section, key, buffer);
+            result += '\n';
+        }
+    }
+
+    std::optional<size_t> findSection(std::string_view name) const
+    {
+        if (equalsSettingsName(name, kDescriptionSection))
+        {
+            return kDescriptionSectionIndex;
+        }
+        if (equalsSettingsName(name, kBackendSection))
+        {
+            return kBackendSectionIndex;
+        }
+
+        // Category section is "[<Module>.<Category>]", since categories of different modules may have same names
+        if (!isModuleSectionName(name))
+        {
+            return std::nullopt;
+        }
+
+        const auto categoryName = name.substr(kLoggerName.size() + 1);
+        auto category           = Tree::find(categoryName);
+        if (!category)
+        {
+            category = findSettingsName(categoryName, Tree::kNodesCount, &Tree::getName);
+        }
+        if (category)
+        {
+            return kCategorySectionsOffset + *category;
+        }
+
+        const auto& dynamicCategories = m_state->dynamicCategories;
+        const auto dynamicCategory    = findSettingsName(categoryName, m_dynamicSectionsCount,
+            [&dynamicCategories](size_t i) { return std::string_view(dynamicCategories[i].name); });
+        return dynamicCategory ? std::optional<size_t>(kSectionsCount + *dynamicCategory) : std::nullopt;
+    }
+
+    static bool isModuleSectionName(std::string_view name)
+    {
+        return name.size() > kLoggerName.size() && equalsSettingsName(name.substr(0, kLoggerName.size()), kLoggerName) &&
+               name[kLoggerName.size()] == '.';
+    }
+
+    static std::optional<size_t> findCategoryName(std::string_view name)
+    {
+        const auto category = kCategoryNames<Category>.find(name);
+        return category ? category
+                        : findSettingsName(name, Category::getSize(),
+                              [](size_t i) { return std::string_view(Category::toString(static_cast<BaseCategory>(i))); });
+    }
+
+    // "[<Category>]" of files written before sections were named by module and "[<Module>.<Parent>_<Child>]" of files
+    // written before categories had dotted names
+    static std::optional<size_t> findLegacyCategory(std::string_view name)
+    {
+        if (isModuleSectionName(name))
+        {
+            const auto category = findCategoryName(name.substr(kLoggerName.size() + 1));
+            if (category)
+            {
+                return category;
+            }
+        }
+        return findCategoryName(name);
+    }
+
+    // Sections of groups follow sections of categories, then sections of dynamic categories follow them
+    size_t getSectionsCount() const
+    {
+        return kSectionsCount + m_dynamicSectionsCount;
+    }
+
+    static bool isDynamicSection(size_t section)
+    {
+        return section >= kSectionsCount;
+    }
+
+    // Groups and dynamic categories have levels only
+    static bool hasLevelsOnly(size_t section)
+    {
+        return !Tree::isCategory(section - kCategorySectionsOffset);
+    }
+
+    SinksLogLevel& getSectionSinks(size_t section)
+    {
+        return isDynamicSection(section) ? m_state->dynamicCategories[section - kSectionsCount].sinks
+                                         : m_loggerSinks[section - kCategorySectionsOffset];
+    }
+
+    const SinksLogLevel& getSectionSinks(size_t section) const
+    {
+        return isDynamicSection(section) ? m_state->dynamicCategories[section - kSectionsCount].sinks
+                                         : m_loggerSinks[section - kCategorySectionsOffset];
+    }
+
+    void appendSectionName(std::string& result, size_t section) const
+    {
+        switch (section)
+        {
+        case kDescriptionSectionIndex: result += kDescriptionSection; break;
+        case kBackendSectionIndex:     result += kBackendSection; break;
+        default:
+            result += kLoggerName;
+            result += '.';
+            result += isDynamicSection(section) ? std::string_view(m_state->dynamicCategories[section - kSectionsCount].name)
+                                                : Tree::getName(section - kCategorySectionsOffset);
+            break;
+        }
+    }
+
+    static size_t getKeysCount(size_t section)
+    {
+        switch (section)
+        {
+        case kDescriptionSectionIndex: return getDefaultBackendOptions().log_level_descriptions.size();
+        case kBackendSectionIndex:     return 1;
+        default:                       return CategorySettingsKeys::getSize();
+        }
+    }
+
+    static std::string_view getKeyName(size_t section, size_t key)
+    {
+        switch (section)
+        {
+        case kDescriptionSectionIndex: return getDefaultBackendOptions().log_level_descriptions[key];
+        case kBackendSectionIndex:     return kNumaNodeKey;
+        default:                       return CategorySettingsKeys::toString(static_cast<CategorySettingsKey>(key));
+        }
+    }
+
+    static std::optional<size_t> findKey(size_t section, std::string_view name)
+    {
+        if (section == kDescriptionSectionIndex)
+        {
+            const auto& descriptions = getDefaultBackendOptions().log_level_descriptions;
+            return findSettingsName(
+                name, descriptions.size(), [&descriptions](size_t i) { return std::string_view(descriptions[i]); });
+        }
+        if (section == kBackendSectionIndex)
+        {
+            return equalsSettingsName(name, kNumaNodeKey) ? std::optional<size_t>(0) : std::nullopt;
+        }
+
+        CategorySettingsKey key;
+        if (!CategorySettingsKeys::fromString(name, key))
+        {
+            const auto foundKey = findSettingsName(name, CategorySettingsKeys::getSize(),
+                [](size_t i) { return std::string_view(CategorySettingsKeys::toString(static_cast<CategorySettingsKey>(i))); });
+            if (!foundKey)
+            {
+                return std::nullopt;
+            }
+            key = static_cast<CategorySettingsKey>(*foundKey);
+        }
+
+        // Other keys of sections with levels only are kept as unknown
+        if (hasLevelsOnly(section) && key != CategorySettingsKeys::Console && key != CategorySettingsKeys::File)
+        {
+            return std::nullopt;
+        }
+        return key;
+    }
+
+    // Burst and per level limit are written only for limited category, inherited levels are written only in parent
+    bool isSettingWritten(size_t section, size_t key) const
+    {
+        if (section < kCategorySectionsOffset)
+        {
+            return true;
+        }
+
+        if (key == CategorySettingsKeys::Console || key == CategorySettingsKeys::File)
+        {
+            return !getSectionSinks(section).logLevels.at(getLogSource(key)).isInherited;
+        }
+
+        if (hasLevelsOnly(section))
+        {
+            return false;
+        }
+
+        const auto& settings = m_categorySettings[section - kCategorySectionsOffset];
+        return settings.rateLimit != 0.0 ||
+               (key != CategorySettingsKeys::RateLimitBurst && key != CategorySettingsKeys::RateLimitPerLevel);
+    }
+
+    // False if value is invalid, then default value is kept
+    bool applySetting(size_t section, size_t key, std::string_view value)
+    {
+        if (section == kDescriptionSectionIndex)
+        {
+            // Descriptions of short codes are written for reference only
+            return true;
+        }
+
+        if (section == kBackendSectionIndex)
+        {
+            const auto numaNode = parseSettingsValue<long>(value);
+            m_backendNumaNode   = static_cast<int>(std::max(numaNode.value_or(kNoNumaNode), kNoNumaNode));
+            return numaNode.has_value();
+        }
+
+        if (key == CategorySettingsKeys::Console || key == CategorySettingsKeys::File)
+        {
+            auto& logLevel = getSectionSinks(section).logLevels[getLogSource(key)];
+            return SinksLogLevel::LogLevels::fromString(value, logLevel.currentLogLevel);
+        }
+
+        auto& settings = m_categorySettings[section - kCategorySectionsOffset];
+        switch (static_cast<CategorySettingsKey>(key))
+        {
+        case CategorySettingsKeys::SampleRate:
+            return applyNumber(value, settings.sampleRate, 0.0, 1.0);
+        case CategorySettingsKeys::RateLimit:
+            return applyNumber(value, settings.rateLimit, 0.0, std::numeric_limits<double>::max());
+        case CategorySettingsKeys::RateLimitBurst:
+            return applyNumber(value, settings.rateLimitBurst, 1.0, std::numeric_limits<double>::max());
+        case CategorySettingsKeys::RateLimitPerLevel:
+        {
+            const auto perLevel = parseSettingsValue<bool>(value);
+            settings.rateLimitPerLevel = perLevel.value_or(settings.rateLimitPerLevel);
+            return perLevel.has_value();
+        }
+        case CategorySettingsKeys::CoalesceWindowMs:
+            return applyNumber(value, settings.coalesceWindowMs, 0L, std::numeric_limits<long>::max());
+        case CategorySettingsKeys::BacktraceLength:
+            return applyNumber(value, settings.backtraceLength, 0L, static_cast<long>(std::numeric_limits<uint32_t>::max()));
+        case CategorySettingsKeys::BacktraceFlush:
+            return SinksLogLevel::LogLevels::fromString(value, settings.backtraceFlush);
+        default:
+            return false;
+        }
+    }
+
+    template <class TNumber>
+    static bool applyNumber(std::string_view value, TNumber& setting, TNumber min, TNumber max)
+    {
+        const auto number = parseSettingsValue<TNumber>(value);
+        if (number)
+        {
+            setting = std::clamp(*number, min, max);
+        }
+        return number.has_value();
+    }
+
+    std::string_view formatSetting(size_t section, size_t key, SettingsValueBuffer& buffer) const
+    {
+        if (section == kDescriptionSectionIndex)
+        {
+            return getDefaultBackendOptions().log_level_short_codes[key];
+        }
+
+        if (section == kBackendSectionIndex)
+        {
+            return formatSettingsValue(static_cast<long>(m_backendNumaNode), buffer);
+        }
+
+        if (key == CategorySettingsKeys::Console || key == CategorySettingsKeys::File)
+        {
+            return SinksLogLevel::LogLevels::toString(getSectionSinks(section).logLevels.at(getLogSource(key)).currentLogLevel);
+        }
+
+        const auto& settings = m_categorySettings[section - kCategorySectionsOffset];
+        switch (static_cast<CategorySettingsKey>(key))
+        {
+        case CategorySettingsKeys::SampleRate:        return formatSettingsValue(settings.sampleRate, buffer);
+        case CategorySettingsKeys::RateLimit:         return formatSettingsValue(settings.rateLimit, buffer);
+        case CategorySettingsKeys::RateLimitBurst:    return formatSettingsValue(settings.rateLimitBurst, buffer);
+        case CategorySettingsKeys::RateLimitPerLevel: return formatSettingsValue(settings.rateLimitPerLevel, buffer);
+        case CategorySettingsKeys::CoalesceWindowMs:  return formatSettingsValue(settings.coalesceWindowMs, buffer);
+        case CategorySettingsKeys::BacktraceLength:   return formatSettingsValue(settings.backtraceLength, buffer);
+        case CategorySettingsKeys::BacktraceFlush:    return SinksLogLevel::LogLevels::toString(settings.backtraceFlush);
+        default:                                      return {};
+        }
+    }
+
+    static typename SinksLogLevel::LogSource getLogSource(size_t key)
+    {
+        return key == CategorySettingsKeys::Console ? SinksLogLevel::LogSources::Console : SinksLogLevel::LogSources::File;
+    }
+
+    void applyCategorySettings(BaseCategory category, bool isBurstSet)
+    {
+        auto& settings = m_categorySettings[category];
+
+        m_sampleThresholds[category] = logger::getSampleThreshold(settings.sampleRate);
+
+        if (settings.rateLimit != 0.0)
+        {
+            if (!isBurstSet)
+            {
+                settings.rateLimitBurst = std::max(settings.rateLimit, 1.0);
+            }
+
+            m_state->rateLimiters[category] =
+                std::make_unique<CategoryRateLimiter>(settings.rateLimit, settings.rateLimitBurst, settings.rateLimitPerLevel);
+            m_rateLimiters[category] = m_state->rateLimiters[category].get();
+        }
+
+        const auto coalesceWindowNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(settings.coalesceWindowMs)).count());
+        for (auto& route : m_state->categories[category].routes)
+        {
+            route.coalescing.windowNs.store(coalesceWindowNs, std::memory_order_relaxed);
+        }
+
+        m_backtraceSettings[category] = BacktraceSettings{static_cast<uint32_t>(settings.backtraceLength),
+            getLogLevelByShortName(SinksLogLevel::LogLevels::toString(settings.backtraceFlush))};
+    }
+
+    static const quill::BackendOptions& getDefaultBackendOptions()
+    {
+        static const quill::BackendOptions kOptions;
+        return kOptions;
+    }
+
+    // Logger, its console sink and sink routes are named <Module>.<Category>, so modules with same category names
+    // don't share them
+    static std::string getLoggerName(std::string_view category)
+    {
+        return std::string(kLoggerName) + '.' + std::string(category);
+    }
+
+    // Pattern shows category name instead of logger name, it is centered in column like "%(logger:^width)"
+    static std::string getPatternFormatter(std::string_view category)
+    {
+        // "+ 2" for whitespaces in begin and end. Longer names exceed column, so it isn't widened by deep categories
+        constexpr auto width = std::min(Tree::getMaxCategoryNameLength(), kMaxCategoryColumnWidth) + 2;
+        const auto padding   = width > category.size() ? width - category.size() : 0;
+
+        std::string pattern(kPatternFormatterLogsPart1);
+        pattern += kLoggerName;
+        pattern += kPatternFormatterLogsPart2;
+        pattern.append(padding / 2, ' ');
+        pattern += category;
+        pattern.append(padding - padding / 2, ' ');
+        pattern += kPatternFormatterLogsPart3;
+        return pattern;
+    }
+
+    static constexpr std::string_view kDescriptionSection = "Description";
+    static constexpr std::string_view kBackendSection     = "Backend";
+    static constexpr std::string_view kNumaNodeKey        = "NumaNode";
+
+    // Sections of settings file owned by module: level descriptions, backend and one per category or group
+    static constexpr size_t kDescriptionSectionIndex = 0;
+    static constexpr size_t kBackendSectionIndex     = 1;
+    static constexpr size_t kCategorySectionsOffset  = 2;
+    static constexpr size_t kSectionsCount           = kCategorySectionsOffset + Tree::kNodesCount;
+    static constexpr size_t kMaxSectionKeys          = 16;
+
+    static constexpr size_t kMaxDynamicCategories = AppendOnlyList<DynamicCategoryState>::capacity();
+
+    static constexpr long kNoNumaNode = -1;
+
+    static constexpr auto kRateLimitReportInterval = std::chrono::seconds(10);
+    static constexpr size_t kDefaultCallSitesCount = 10;
+
+    static constexpr std::string_view kPatternFormatterTime = "%H:%M:%S.%Qns";
+    static constexpr size_t kMaxCategoryColumnWidth         = 16;
+
+    static constexpr std::string_view kPatternFormatterLogsPart1 =
+        "[%(time)] [%(thread_id)] [%(short_source_location:^28)] [%(log_level:^11)] [ ";
+    static constexpr std::string_view kPatternFormatterLogsPart2 = " ] [";
+    static constexpr std::string_view kPatternFormatterLogsPart3 = "] %(message)";
+
+    static constexpr std::string_view kLoggerName = LoggerName;
+
+    static constexpr std::string_view kInternalLoggerName  = "Internal";
+    static constexpr std::string_view kTraceSinkNameSuffix = ".TraceEvents";
+
+    std::string m_settingsFileName;
+    bool m_backendStarted = false;
+    StartupProfile m_startupProfile;
+
+    std::array<logger::Logger*, Category::getSize()> m_loggers;
+    std::array<SinksLogLevel, Tree::kNodesCount> m_loggerSinks;
+    std::array<CategorySettings, Category::getSize()> m_categorySettings;
+    std::array<uint64_t, Category::getSize()> m_sampleThresholds;
+    std::array<CategoryRateLimiter*, Category::getSize()> m_rateLimiters{};
+
+    struct BacktraceSettings
+    {
+        uint32_t length            = BacktraceLength;
+        quill::LogLevel flushLevel = quill::LogLevel::Critical;
+    };
+
+    std::array<BacktraceSettings, Category::getSize()> m_backtraceSettings;
+    int m_backendNumaNode = kNoNumaNode;
+    std::array<std::once_flag, Category::getSize()> m_backtraceInitFlags;
+    std::shared_ptr<ModuleState> m_state = std::make_shared<ModuleState>();
+    std::shared_ptr<TraceEventSink> m_traceSink;
+
+    // Dynamic categories with sections known to settings functions, category is published after its section is applied
+    std::mutex m_dynamicCategoriesMutex;
+    size_t m_dynamicSectionsCount = 0;
+
+    // Reporter tasks of reports enabled at runtime
+    std::mutex m_reportTasksMutex;
+    std::optional<PeriodicReporter::TaskId> m_latencyDumpTask;
+    std::optional<PeriodicReporter::TaskId> m_callSiteDumpTask;
+};
+}  // namespace logger
+
+// clang-format off
+#define DEFINE_CAT_LOGGER_MODULE(Name, CategoryType, BacktraceLength)                                      \
+    extern const char s_##Name##LoggerName[];                                                              \
+    extern logger::CategorizedLogger<CategoryType, s_##Name##LoggerName, BacktraceLength> s_##Name##Logger
+
+#define DEFINE_CAT_LOGGER_MODULE_INITIALIZATION(Name, CategoryType, BacktraceLength)                \
+    inline constexpr char s_##Name##LoggerName[] = #Name;                                           \
+    logger::CategorizedLogger<CategoryType, s_##Name##LoggerName, BacktraceLength> s_##Name##Logger
+
+// Module constructed on first use or by s_<Name>Logger.init(options), see PreInitPolicy for messages logged before init
+#define DEFINE_CAT_LOGGER_MODULE_LAZY(Name, CategoryType, BacktraceLength)                                               \
+    extern const char s_##Name##LoggerName[];                                                                            \
+    extern logger::LazyCategorizedLogger<logger::CategorizedLogger<CategoryType, s_##Name##LoggerName, BacktraceLength>> \
+        s_##Name##Logger
+
+#define DEFINE_CAT_LOGGER_MODULE_LAZY_INITIALIZATION(Name, CategoryType, BacktraceLength, Policy)                           \
+    inline constexpr char s_##Name##LoggerName[] = #Name;                                                                   \
+    constinit logger::LazyCategorizedLogger<logger::CategorizedLogger<CategoryType, s_##Name##LoggerName, BacktraceLength>> \
+        s_##Name##Logger{Policy}
+
+#define GET_LOGGER(LoggerName, name, catName) logger::s_##LoggerName##Logger.getLogger(logger::catName::name)
+
+// Backtrace of category is initialized on first use, messages of category with zero BacktraceLength are dropped
+#define CAT_LOG_IF_BACKTRACE(logName, catName, cat, statement)                                                 \
+    do                                                                                                         \
+    {                                                                                                          \
+        if (logger::s_##logName##Logger.initBacktrace(logger::catName::cat))                                   \
+        {                                                                                                      \
+            logger::detail::syncTaskContext();                                                                 \
+            statement;                                                                                         \
+        }                                                                                                      \
+    } while (0)
+
+// Messages over category rate limit or queue memory budget are dropped here, before arguments are evaluated and encoded
+#define CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, level, statement)                                        \
+    do                                                                                                         \
+    {                                                                                                          \
+        if (logger::s_##logName##Logger.canEnqueue(logger::catName::cat, quill::LogLevel::level))              \
+        {                                                                                                      \
+            statement;                                                                                         \
+        }                                                                                                      \
+    } while (0)
+
+// LOG_INFO
+#define CAT_LOG_TRACE_L3(logName, catName, cat, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL3, QUILL_LOG_TRACE_L3(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_TRACE_L2(logName, catName, cat, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL2, QUILL_LOG_TRACE_L2(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_TRACE_L1(logName, catName, cat, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL1, QUILL_LOG_TRACE_L1(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_DEBUG(logName, catName, cat, message, ...)     CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Debug, QUILL_LOG_DEBUG(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_INFO(logName, catName, cat, message, ...)      CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Info, QUILL_LOG_INFO(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_NOTICE(logName, catName, cat, message, ...)    CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Notice, QUILL_LOG_NOTICE(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_WARNING(logName, catName, cat, message, ...)   CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Warning, QUILL_LOG_WARNING(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_ERROR(logName, catName, cat, message, ...)     CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Error, QUILL_LOG_ERROR(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_CRITICAL(logName, catName, cat, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Critical, QUILL_LOG_CRITICAL(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_BACKTRACE(logName, catName, cat, message, ...) CAT_LOG_IF_BACKTRACE(logName, catName, cat, QUILL_LOG_BACKTRACE(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+
+// LOGV_INFO
+#define CAT_LOGV_TRACE_L3(logName, catName, cat, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL3, QUILL_LOGV_TRACE_L3(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_TRACE_L2(logName, catName, cat, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL2, QUILL_LOGV_TRACE_L2(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_TRACE_L1(logName, catName, cat, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL1, QUILL_LOGV_TRACE_L1(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_DEBUG(logName, catName, cat, message, ...)     CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Debug, QUILL_LOGV_DEBUG(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_INFO(logName, catName, cat, message, ...)      CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Info, QUILL_LOGV_INFO(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_NOTICE(logName, catName, cat, message, ...)    CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Notice, QUILL_LOGV_NOTICE(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_WARNING(logName, catName, cat, message, ...)   CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Warning, QUILL_LOGV_WARNING(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_ERROR(logName, catName, cat, message, ...)     CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Error, QUILL_LOGV_ERROR(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_CRITICAL(logName, catName, cat, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Critical, QUILL_LOGV_CRITICAL(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOGV_BACKTRACE(logName, catName, cat, message, ...) CAT_LOG_IF_BACKTRACE(logName, catName, cat, QUILL_LOGV_BACKTRACE(GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+
+// LOG_INFO_LIMIT
+#define CAT_LOG_TRACE_L3_LIMIT_TIME(logName, catName, cat, time, message, ...) CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL3, QUILL_LOG_TRACE_L3_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_TRACE_L2_LIMIT_TIME(logName, catName, cat, time, message, ...) CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL2, QUILL_LOG_TRACE_L2_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_TRACE_L1_LIMIT_TIME(logName, catName, cat, time, message, ...) CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL1, QUILL_LOG_TRACE_L1_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_DEBUG_LIMIT_TIME(logName, catName, cat, time, message, ...)    CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Debug, QUILL_LOG_DEBUG_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_INFO_LIMIT_TIME(logName, catName, cat, time, message, ...)     CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Info, QUILL_LOG_INFO_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_NOTICE_LIMIT_TIME(logName, catName, cat, time, message, ...)   CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Notice, QUILL_LOG_NOTICE_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_WARNING_LIMIT_TIME(logName, catName, cat, time, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Warning, QUILL_LOG_WARNING_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_ERROR_LIMIT_TIME(logName, catName, cat, time, message, ...)    CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Error, QUILL_LOG_ERROR_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_CRITICAL_LIMIT_TIME(logName, catName, cat, time, message, ...) CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Critical, QUILL_LOG_CRITICAL_LIMIT(time, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+
+// LOG_INFO_LIMIT_EVERY_N
+#define CAT_LOG_TRACE_L3_LIMIT_EVERY_N(logName, catName, cat, count, message, ...) CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL3, QUILL_LOG_TRACE_L3_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_TRACE_L2_LIMIT_EVERY_N(logName, catName, cat, count, message, ...) CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL2, QUILL_LOG_TRACE_L2_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_TRACE_L1_LIMIT_EVERY_N(logName, catName, cat, count, message, ...) CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, TraceL1, QUILL_LOG_TRACE_L1_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_DEBUG_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)    CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Debug, QUILL_LOG_DEBUG_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_INFO_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)     CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Info, QUILL_LOG_INFO_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_NOTICE_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)   CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Notice, QUILL_LOG_NOTICE_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_WARNING_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)  CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Warning, QUILL_LOG_WARNING_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_ERROR_LIMIT_EVERY_N(logName, catName, cat, count, message, ...)    CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Error, QUILL_LOG_ERROR_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+#define CAT_LOG_CRITICAL_LIMIT_EVERY_N(logName, catName, cat, count, message, ...) CAT_LOG_IF_CAN_ENQUEUE(logName, catName, cat, Critical, QUILL_LOG_CRITICAL_LIMIT_EVERY_N(count, GET_LOGGER(logName, cat, catName), message, ##__VA_ARGS__))
+
+// LOG_INFO_SAMPLE - message is logged with probability "rate" (0.0 - 1.0) and prefixed with it. Rejected sample doesn't evaluate arguments
+#define CAT_LOG_SAMPLE_IMPL(quillMacro, level, logName, catName, cat, threshold, rate, message, ...)                                       \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        auto* catLogSampleLogger = GET_LOGGER(logName, cat, catName);                                                                      \
+        if (quill::LogLevel::level >= static_cast<quill::LogLevel>(QUILL_COMPILE_ACTIVE_LOG_LEVEL) &&                                      \
+            catLogSampleLogger->should_log_statement(quill::LogLevel::level) && logger::shouldSample(threshold) &&                         \
+            logger::s_##logName##Logger.canEnqueue(logger::catName::cat, quill::LogLevel::level))                                          \
+        {                                                                                                                                  \
+            quillMacro(catLogSampleLogger, "[sample {}] " message, rate, ##__VA_ARGS__);                                                   \
+        }                                                                                                                                  \
+    } while (0)
+
+#define CAT_LOG_SAMPLE_RATE_IMPL(quillMacro, level, logName, catName, cat, rate, message, ...) CAT_LOG_SAMPLE_IMPL(quillMacro, level, logName, catName, cat, logger::getSampleThreshold(rate), rate, message, ##__VA_ARGS__)
+#define CAT_LOG_SAMPLE_DEFAULT_IMPL(quillMacro, level, logName, catName, cat, message, ...) CAT_LOG_SAMPLE_IMPL(quillMacro, level, logName, catName, cat, logger::s_##logName##Logger.getSampleThreshold(logger::catName::cat), logger::s_##logName##Logger.getSampleRate(logger::catName::cat), message, ##__VA_ARGS__)
+
+#define CAT_LOG_TRACE_L3_SAMPLE(logName, catName, cat, rate, message, ...) CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_TRACE_L3, TraceL3, logName, catName, cat, rate, message, ##__VA_ARGS__)
+#define CAT_LOG_TRACE_L2_SAMPLE(logName, catName, cat, rate, message, ...) CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_TRACE_L2, TraceL2, logName, catName, cat, rate, message, ##__VA_ARGS__)
+#define CAT_LOG_TRACE_L1_SAMPLE(logName, catName, cat, rate, message, ...) CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_TRACE_L1, TraceL1, logName, catName, cat, rate, message, ##__VA_ARGS__)
+#define CAT_LOG_DEBUG_SAMPLE(logName, catName, cat, rate, message, ...)    CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_DEBUG, Debug, logName, catName, cat, rate, message, ##__VA_ARGS__)
+#define CAT_LOG_INFO_SAMPLE(logName, catName, cat, rate, message, ...)     CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_INFO, Info, logName, catName, cat, rate, message, ##__VA_ARGS__)
+#define CAT_LOG_NOTICE_SAMPLE(logName, catName, cat, rate, message, ...)   CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_NOTICE, Notice, logName, catName, cat, rate, message, ##__VA_ARGS__)
+#define CAT_LOG_WARNING_SAMPLE(logName, catName, cat, rate, message, ...)  CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_WARNING, Warning, logName, catName, cat, rate, message, ##__VA_ARGS__)
+#define CAT_LOG_ERROR_SAMPLE(logName, catName, cat, rate, message, ...)    CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_ERROR, Error, logName, catName, cat, rate, message, ##__VA_ARGS__)
+#define CAT_LOG_CRITICAL_SAMPLE(logName, catName, cat, rate, message, ...) CAT_LOG_SAMPLE_RATE_IMPL(QUILL_LOG_CRITICAL, Critical, logName, catName, cat, rate, message, ##__VA_ARGS__)
+
+// LOG_INFO_SAMPLE_DEFAULT - same, rate is taken from "SampleRate" setting of category
+#define CAT_LOG_TRACE_L3_SAMPLE_DEFAULT(logName, catName, cat, message, ...) CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_TRACE_L3, TraceL3, logName, catName, cat, message, ##__VA_ARGS__)
+#define CAT_LOG_TRACE_L2_SAMPLE_DEFAULT(logName, catName, cat, message, ...) CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_TRACE_L2, TraceL2, logName, catName, cat, message, ##__VA_ARGS__)
+#define CAT_LOG_TRACE_L1_SAMPLE_DEFAULT(logName, catName, cat, message, ...) CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_TRACE_L1, TraceL1, logName, catName, cat, message, ##__VA_ARGS__)
+#define CAT_LOG_DEBUG_SAMPLE_DEFAULT(logName, catName, cat, message, ...)    CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_DEBUG, Debug, logName, catName, cat, message, ##__VA_ARGS__)
+#define CAT_LOG_INFO_SAMPLE_DEFAULT(logName, catName, cat, message, ...)     CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_INFO, Info, logName, catName, cat, message, ##__VA_ARGS__)
+#define CAT_LOG_NOTICE_SAMPLE_DEFAULT(logName, catName, cat, message, ...)   CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_NOTICE, Notice, logName, catName, cat, message, ##__VA_ARGS__)
+#define CAT_LOG_WARNING_SAMPLE_DEFAULT(logName, catName, cat, message, ...)  CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_WARNING, Warning, logName, catName, cat, message, ##__VA_ARGS__)
+#define CAT_LOG_ERROR_SAMPLE_DEFAULT(logName, catName, cat, message, ...)    CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_ERROR, Error, logName, catName, cat, message, ##__VA_ARGS__)
+#define CAT_LOG_CRITICAL_SAMPLE_DEFAULT(logName, catName, cat, message, ...) CAT_LOG_SAMPLE_DEFAULT_IMPL(QUILL_LOG_CRITICAL, Critical, logName, catName, cat, message, ##__VA_ARGS__)
+
+// LOG_ENABLED - true if some sink of category writes message of level. Guards expensive preparation of arguments
+#define CAT_LOG_ENABLED(logName, catName, cat, level)                                                          \
+    (quill::LogLevel::level >= static_cast<quill::LogLevel>(QUILL_COMPILE_ACTIVE_LOG_LEVEL) &&                 \
+        logger::s_##logName##Logger.isEnabled(logger::catName::cat, quill::LogLevel::level))
+
+// LOG_INFO_LAZY - result of function is argument of message, function is called only if message is written. Function is
+// last argument, so lambda with commas needs no parentheses
+#define CAT_LOG_LAZY_IMPL(quillMacro, level, logName, catName, cat, message, ...)                                      \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (CAT_LOG_ENABLED(logName, catName, cat, level) &&                                                           \
+            logger::s_##logName##Logger.canEnqueue(logger::catName::cat, quill::LogLevel::level))                      \
+        {                                                                                                              \
+            quillMacro(GET_LOGGER(logName, cat, catName), message, (__VA_ARGS__)());                                   \
+        }                                                                                                              \
+    } while (0)
+
+#define CAT_LOG_TRACE_L3_LAZY(logName, catName, cat, message, ...) CAT_LOG_LAZY_IMPL(QUILL_LOG_TRACE_L3, TraceL3, logName, catName, cat, message, __VA_ARGS__)
+#define CAT_LOG_TRACE_L2_LAZY(logName, catName, cat, message, ...) CAT_LOG_LAZY_IMPL(QUILL_LOG_TRACE_L2, TraceL2, logName, catName, cat, message, __VA_ARGS__)
+#define CAT_LOG_TRACE_L1_LAZY(logName, catName, cat, message, ...) CAT_LOG_LAZY_IMPL(QUILL_LOG_TRACE_L1, TraceL1, logName, catName, cat, message, __VA_ARGS__)
+#define CAT_LOG_DEBUG_LAZY(logName, catName, cat, message, ...)    CAT_LOG_LAZY_IMPL(QUILL_LOG_DEBUG, Debug, logName, catName, cat, message, __VA_ARGS__)
+#define CAT_LOG_INFO_LAZY(logName, catName, cat, message, ...)     CAT_LOG_LAZY_IMPL(QUILL_LOG_INFO, Info, logName, catName, cat, message, __VA_ARGS__)
+#define CAT_LOG_NOTICE_LAZY(logName, catName, cat, message, ...)   CAT_LOG_LAZY_IMPL(QUILL_LOG_NOTICE, Notice, logName, catName, cat, message, __VA_ARGS__)
+#define CAT_LOG_WARNING_LAZY(logName, catName, cat, message, ...)  CAT_LOG_LAZY_IMPL(QUILL_LOG_WARNING, Warning, logName, catName, cat, message, __VA_ARGS__)
+#define CAT_LOG_ERROR_LAZY(logName, catName, cat, message, ...)    CAT_LOG_LAZY_IMPL(QUILL_LOG_ERROR, Error, logName, catName, cat, message, __VA_ARGS__)
+#define CAT_LOG_CRITICAL_LAZY(logName, catName, cat, message, ...) CAT_LOG_LAZY_IMPL(QUILL_LOG_CRITICAL, Critical, logName, catName, cat, message, __VA_ARGS__)
+
+// LOG_SCOPE_TIME - logs "<label> took <duration>" on scope exit. Disabled by category level or compile time level costs one branch or nothing
+#if QUILL_COMPILE_ACTIVE_LOG_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_TRACE_L3
+#define CAT_LOG_SCOPE_TIME_TRACE_L3(logName, catName, cat, label) CAT_LOG_SCOPE_TIME_IMPL(QUILL_LOG_TRACE_L3, TraceL3, logName, catName, cat, label)
+#else
+#define CAT_LOG_SCOPE_TIME_TRACE_L3(logName, catName, cat, label) static_cast<void>(0)
+#endif
+
+#if QUILL_COMPILE_ACTIVE_LOG_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_TRACE_L2
+#define CAT_LOG_SCOPE_TIME_TRACE_L2(logName, catName, cat, label) CAT_LOG_SCOPE_TIME_IMPL(QUILL_LOG_TRACE_L2, TraceL2, logName, catName, cat, label)
+#else
+#define CAT_LOG_SCOPE_TIME_TRACE_L2(logName, catName, cat, label) static_cast<void>(0)
+#endif
+
+#if QUILL_COMPILE_ACTIVE_LOG_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_TRACE_L1
+#define CAT_LOG_SCOPE_TIME_TRACE_L1(logName, catName, cat, label) CAT_LOG_SCOPE_TIME_IMPL(QUILL_LOG_TRACE_L1, TraceL1, logName, catName, cat, label)
+#else
+#define CAT_LOG_SCOPE_TIME_TRACE_L1(logName, catName, cat, label) static_cast<void>(0)
+#endif
+
+#if QUILL_COMPILE_ACTIVE_LOG_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_DEBUG
+#define CAT_LOG_SCOPE_TIME_DEBUG(logName, catName, cat, label) CAT_LOG_SCOPE_TIME_IMPL(QUILL_LOG_DEBUG, Debug, logName, catName, cat, label)
+#else
+#define CAT_LOG_SCOPE_TIME_DEBUG(logName, catName, cat, label) static_cast<void>(0)
+#endif
+
+#if QUILL_COMPILE_ACTIVE_LOG_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_INFO
+#define CAT_LOG_SCOPE_TIME_INFO(logName, catName, cat, label) CAT_LOG_SCOPE_TIME_IMPL(QUILL_LOG_INFO, Info, logName, catName, cat, label)
+#else
+#define CAT_LOG_SCOPE_TIME_INFO(logName, catName, cat, label) static_cast<void>(0)
+#endif
+
+#define CAT_LOG_SCOPE_TIME(logName, catName, cat, label) CAT_LOG_SCOPE_TIME_DEBUG(logName, catName, cat, label)
+
+// LOG_INFO for dynamic category - "category" is logger::DynamicCategory handle, messages of empty handle are dropped
+#define CAT_LOG_DYNAMIC_IMPL(quillMacro, level, category, message, ...)                                      \
+    do                                                                                                         \
+    {                                                                                                          \
+        const auto& catLogDynamicCategory = category;                                                          \
+        if (catLogDynamicCategory.canEnqueue(quill::LogLevel::level))                                          \
+        {                                                                                                      \
+            quillMacro(catLogDynamicCategory.getLogger(), message, ##__VA_ARGS__);                             \
+        }                                                                                                      \
+    } while (0)
+
+#define CAT_LOG_DYNAMIC_TRACE_L3(category, message, ...) CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_TRACE_L3, TraceL3, category, message, ##__VA_ARGS__)
+#define CAT_LOG_DYNAMIC_TRACE_L2(category, message, ...) CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_TRACE_L2, TraceL2, category, message, ##__VA_ARGS__)
+#define CAT_LOG_DYNAMIC_TRACE_L1(category, message, ...) CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_TRACE_L1, TraceL1, category, message, ##__VA_ARGS__)
+#define CAT_LOG_DYNAMIC_DEBUG(category, message, ...)    CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_DEBUG, Debug, category, message, ##__VA_ARGS__)
+#define CAT_LOG_DYNAMIC_INFO(category, message, ...)     CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_INFO, Info, category, message, ##__VA_ARGS__)
+#define CAT_LOG_DYNAMIC_NOTICE(category, message, ...)   CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_NOTICE, Notice, category, message, ##__VA_ARGS__)
+#define CAT_LOG_DYNAMIC_WARNING(category, message, ...)  CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_WARNING, Warning, category, message, ##__VA_ARGS__)
+#define CAT_LOG_DYNAMIC_ERROR(category, message, ...)    CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_ERROR, Error, category, message, ##__VA_ARGS__)
+#define CAT_LOG_DYNAMIC_CRITICAL(category, message, ...) CAT_LOG_DYNAMIC_IMPL(QUILL_LOG_CRITICAL, Critical, category, message, ##__VA_ARGS__)
 // clang-format on
@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include <quill/core/LogLevel.h>
+
+#include <type_traits>
+#include <utility>
+
+#include "Frontend.hpp"
+#include "LogFormat.hpp"
+
+namespace logger {
+template <auto& Module, auto Category>
+constexpr void checkCategory()
+{
+    static_assert(std::is_same_v<decltype(Category), typename std::remove_cvref_t<decltype(Module)>::CategoryEnum>,
+        "Category must be enumerator of GENENUM of logger module");
+}
+
+// Same as CAT_LOG_* defines without macros: logger::log<s_CoreLauncherLogger, CoreLauncherSources::Core>(...). Module
+// and category are known at compile time, so logger of category is taken from known address. Level is checked before
+// call site metadata is looked up and arguments are encoded
+template <auto& Module, auto Category, class... Args>
+void log(quill::LogLevel logLevel, LogFormat format, Args&&... args)
+{
+    checkCategory<Module, Category>();
+
+    auto* categoryLogger = Module.getLogger(Category);
+    if (categoryLogger->should_log_statement(logLevel) && Module.canEnqueue(Category, logLevel))
+    {
+        categoryLogger->log_statement(getCallSiteMetadata(format, logLevel), std::forward<Args>(args)...);
+    }
+}
+
+// Category of logger module with logger resolved once, for hot paths which keep it, e.g. as member. Creating handle of
+// lazy module initializes it
+template <auto& Module, auto Category>
+class CategoryHandle
+{
+public:
+    CategoryHandle() : m_module(&getModule()), m_logger(m_module->getLogger(Category))
+    {
+        checkCategory<Module, Category>();
+    }
+
+    bool isEnabled(quill::LogLevel logLevel) const noexcept
+    {
+        return m_logger->should_log_statement(logLevel);
+    }
+
+    template <class... Args>
+    void log(quill::LogLevel logLevel, LogFormat format, Args&&... args) const
+    {
+        if (m_logger->should_log_statement(logLevel) && m_module->canEnqueue(Category, logLevel))
+        {
+            m_logger->log_statement(getCallSiteMetadata(format, logLevel), std::forward<Args>(args)...);
+        }
+    }
+
+    logger::Logger* getLogger() const noexcept
+    {
+        return m_logger;
+    }
+
+private:
+    static auto& getModule()
+    {
+        if constexpr (requires { Module.get(); })
+        {
+            return Module.get();
+        }
+        else
+        {
+            return Module;
+        }
+    }
+
+    std::remove_reference_t<decltype(getModule())>* m_module;
+    logger::Logger* m_logger;
+};
+}  // namespace logger
@@ -0,0 +1,201 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "PerfectHash.hpp"
+
+namespace logger {
+namespace detail {
+// Leading, trailing and repeated '_' don't split name
+constexpr bool isCategorySeparator(std::string_view name, size_t pos)
+{
+    return name[pos] == '_' && pos != 0 && pos + 1 != name.size() && name[pos - 1] != '_';
+}
+
+template <size_t MaxNodes>
+struct CategoryNodes
+{
+    std::array<std::string_view, MaxNodes> names{};
+    size_t count = 0;
+};
+
+template <class TCategory>
+consteval size_t getMaxCategoryNodesCount()
+{
+    size_t count = TCategory::getSize();
+    for (typename TCategory::baseType i = 0; i < TCategory::getSize(); ++i)
+    {
+        count += std::ranges::count(TCategory::toString(i), '_');
+    }
+    return count;
+}
+
+// Categories in order of declaration, then groups in order of first child
+template <class TCategory>
+consteval auto getCategoryNodes()
+{
+    CategoryNodes<getMaxCategoryNodesCount<TCategory>()> nodes;
+    for (typename TCategory::baseType i = 0; i < TCategory::getSize(); ++i)
+    {
+        nodes.names[nodes.count++] = TCategory::toString(i);
+    }
+
+    for (typename TCategory::baseType i = 0; i < TCategory::getSize(); ++i)
+    {
+        const auto name = TCategory::toString(i);
+        for (size_t pos = 0; pos < name.size(); ++pos)
+        {
+            const auto parent = name.substr(0, pos);
+            const auto end    = nodes.names.begin() + nodes.count;
+            if (isCategorySeparator(name, pos) && std::find(nodes.names.begin(), end, parent) == end)
+            {
+                nodes.names[nodes.count++] = parent;
+            }
+        }
+    }
+    return nodes;
+}
+
+template <class TCategory>
+inline constexpr auto kCategoryNodes = getCategoryNodes<TCategory>();
+
+template <class TCategory>
+inline constexpr size_t kCategoryNodesCount = kCategoryNodes<TCategory>.count;
+
+// Dotted names of all nodes, each is null terminated
+template <class TCategory>
+consteval auto getCategoryNodeChars()
+{
+    constexpr auto kSize = []()
+    {
+        size_t size = 0;
+        for (size_t i = 0; i < kCategoryNodesCount<TCategory>; ++i)
+        {
+            size += kCategoryNodes<TCategory>.names[i].size() + 1;
+        }
+        return size;
+    }();
+
+    std::array<char, kSize> chars{};
+    auto* ptr = chars.data();
+    for (size_t i = 0; i < kCategoryNodesCount<TCategory>; ++i)
+    {
+        const auto name = kCategoryNodes<TCategory>.names[i];
+        for (size_t pos = 0; pos < name.size(); ++pos)
+        {
+            *ptr++ = isCategorySeparator(name, pos) ? '.' : name[pos];
+        }
+        *ptr++ = '\0';
+    }
+    return chars;
+}
+
+template <class TCategory>
+inline constexpr auto kCategoryNodeChars = getCategoryNodeChars<TCategory>();
+
+template <class TCategory>
+consteval auto getCategoryNodeNames()
+{
+    std::array<std::string_view, kCategoryNodesCount<TCategory>> names;
+
+    const auto* ptr = kCategoryNodeChars<TCategory>.data();
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        names[i] = std::string_view(ptr, kCategoryNodes<TCategory>.names[i].size());
+        ptr += names[i].size() + 1;
+    }
+    return names;
+}
+
+template <class TCategory>
+inline constexpr auto kCategoryNodeNames = getCategoryNodeNames<TCategory>();
+
+// Parent is prefix of name before last separator, it is always node
+template <class TCategory>
+consteval auto getCategoryNodeParents()
+{
+    const auto& nodes = kCategoryNodes<TCategory>;
+
+    std::array<size_t, kCategoryNodesCount<TCategory>> parents;
+    for (size_t i = 0; i < parents.size(); ++i)
+    {
+        parents[i] = SIZE_MAX;
+        for (size_t pos = nodes.names[i].size(); pos-- > 0;)
+        {
+            if (isCategorySeparator(nodes.names[i], pos))
+            {
+                const auto begin = nodes.names.begin();
+                parents[i] = std::find(begin, begin + nodes.count, nodes.names[i].substr(0, pos)) - begin;
+                break;
+            }
+        }
+    }
+    return parents;
+}
+}  // namespace detail
+
+// Categories named "<Parent>_<Child>" form tree and are shown with dotted names, e.g. Net_Tcp is "Net.Tcp", child of
+// "Net". Parent which is not category itself is group: it has settings section, but no logger. Nodes are categories
+// in order of declaration, followed by groups. Tree is built at compile time
+template <class TCategory>
+class CategoryTree
+{
+public:
+    static constexpr size_t kCategoriesCount = TCategory::getSize();
+    static constexpr size_t kNodesCount      = detail::kCategoryNodesCount<TCategory>;
+    static constexpr size_t kNoParent        = SIZE_MAX;
+
+    // Null terminated
+    static constexpr std::string_view getName(size_t node) noexcept
+    {
+        return detail::kCategoryNodeNames<TCategory>[node];
+    }
+
+    static constexpr size_t getParent(size_t node) noexcept
+    {
+        return kParents[node];
+    }
+
+    static constexpr bool isCategory(size_t node) noexcept
+    {
+        return node < kCategoriesCount;
+    }
+
+    static constexpr bool isAncestor(size_t ancestor, size_t node) noexcept
+    {
+        for (auto parent = kParents[node]; parent != kNoParent; parent = kParents[parent])
+        {
+            if (parent == ancestor)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Node by dotted name
+    static constexpr std::optional<size_t> find(std::string_view name) noexcept
+    {
+        return kNames.find(name);
+    }
+
+    static constexpr size_t getMaxCategoryNameLength() noexcept
+    {
+        size_t length = 0;
+        for (size_t i = 0; i < kCategoriesCount; ++i)
+        {
+            length = std::max(length, getName(i).size());
+        }
+        return length;
+    }
+
+private:
+    static constexpr auto kParents = detail::getCategoryNodeParents<TCategory>();
+    static constexpr PerfectHash<kNodesCount> kNames{detail::kCategoryNodeNames<TCategory>};
+};
+}  // namespace logger
@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include <quill/core/LogLevel.h>
+
+#include <string>
+#include <string_view>
+
+#include "Frontend.hpp"
+#include "QueueBudget.hpp"
+#include "TaskContext.hpp"
+
+namespace logger {
+struct DynamicCategoryOptions
+{
+    quill::LogLevel consoleLogLevel = quill::LogLevel::Info;
+    quill::LogLevel fileLogLevel    = quill::LogLevel::TraceL3;
+};
+
+// Part of dynamic category used by logging defines
+struct DynamicCategoryEntry
+{
+    std::string name;
+    logger::Logger* logger = nullptr;
+};
+
+// Handle of category registered at runtime. It stays valid until logger module is destroyed, so plugins look it up
+// once and cache it. Empty handle drops all messages
+class DynamicCategory
+{
+public:
+    DynamicCategory() = default;
+
+    explicit DynamicCategory(DynamicCategoryEntry* entry) noexcept : m_entry(entry)
+    {
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_entry != nullptr;
+    }
+
+    std::string_view getName() const noexcept
+    {
+        return m_entry != nullptr ? std::string_view(m_entry->name) : std::string_view{};
+    }
+
+    logger::Logger* getLogger() const noexcept
+    {
+        return m_entry->logger;
+    }
+
+    // Same check as logging defines of static categories do, except rate limit
+    bool canEnqueue(quill::LogLevel logLevel) const noexcept
+    {
+        if (m_entry == nullptr)
+        {
+            return false;
+        }
+        if (!m_entry->logger->should_log_statement(logLevel))
+        {
+            return true;
+        }
+        if (!acquireQueueBudget())
+        {
+            return false;
+        }
+
+        detail::syncTaskContext();
+        return true;
+    }
+
+private:
+    DynamicCategoryEntry* m_entry = nullptr;
+};
+}  // namespace logger
@@ -0,0 +1,24 @@
+﻿#pragma once
+
+#include <quill/Frontend.h>
+#include <quill/Logger.h>
+#include <quill/core/FrontendOptions.h>
+
+namespace logger {
+// Frontend queue options of all logger modules. Type of loggers depends on them, so they are set for whole build.
+// Without custom options loggers are default quill types and can be shared with code using quill directly
+#if defined(LOGGER_HUGE_PAGES)
+struct FrontendOptions : quill::FrontendOptions
+{
+    // Queues are allocated from 2 MiB pages when system has them, otherwise from regular pages (Linux only)
+    static constexpr quill::HugePagesPolicy huge_pages_policy = quill::HugePagesPolicy::Try;
+};
+
+using Frontend = quill::FrontendImpl<FrontendOptions>;
+using Logger   = quill::LoggerImpl<FrontendOptions>;
+#else
+using FrontendOptions = quill::FrontendOptions;
+using Frontend        = quill::Frontend;
+using Logger          = quill::Logger;
+#endif
+}  // namespace logger
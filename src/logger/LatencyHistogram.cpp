@@ -0,0 +1,90 @@
+﻿#include "LatencyHistogram.hpp"
+
+#include <bit>
+
+#include "LoggerStats.hpp"
+
+uint32_t logger::LatencyHistogram::getBucketIndex(uint64_t value) noexcept
+{
+    if (value < kExactBucketsCount)
+    {
+        return static_cast<uint32_t>(value);
+    }
+
+    const auto valueBits = static_cast<uint32_t>(std::bit_width(value));
+    if (valueBits > kMaxValueBits)
+    {
+        return kBucketsCount - 1;
+    }
+
+    // Keep (kSubBucketBits + 1) most significant bits, highest of them is always set
+    const auto shift     = valueBits - kSubBucketBits - 1;
+    const auto subBucket = static_cast<uint32_t>(value >> shift) - kSubBucketsCount;
+    return kExactBucketsCount + (shift - 1) * kSubBucketsCount + subBucket;
+}
+
+uint64_t logger::LatencyHistogram::getBucketLowerBound(uint32_t index) noexcept
+{
+    if (index < kExactBucketsCount)
+    {
+        return index;
+    }
+
+    const auto shift     = (index - kExactBucketsCount) / kSubBucketsCount + 1;
+    const auto subBucket = (index - kExactBucketsCount) % kSubBucketsCount;
+    return static_cast<uint64_t>(kSubBucketsCount + subBucket) << shift;
+}
+
+void logger::LatencyHistogram::record(uint64_t value) noexcept
+{
+    incrementCounter(m_counts[getBucketIndex(value)]);
+    incrementCounter(m_count);
+    incrementCounter(m_sum, value);
+
+    if (value > m_max.load(std::memory_order_relaxed))
+    {
+        m_max.store(value, std::memory_order_relaxed);
+    }
+}
+
+logger::LatencyHistogram::Snapshot logger::LatencyHistogram::load() const noexcept
+{
+    Snapshot snapshot;
+    for (uint32_t i = 0; i < kBucketsCount; ++i)
+    {
+        snapshot.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count = m_count.load(std::memory_order_relaxed);
+    snapshot.sum   = m_sum.load(std::memory_order_relaxed);
+    snapshot.max   = m_max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+uint64_t logger::LatencyHistogram::Snapshot::getPercentile(double percentile) const noexcept
+{
+    constexpr double kHundredPercent = 100.0;
+
+    uint64_t total = 0;
+    for (auto bucketCount : counts)
+    {
+        total += bucketCount;
+    }
+
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    const auto rank = static_cast<uint64_t>(percentile / kHundredPercent * static_cast<double>(total - 1)) + 1;
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kBucketsCount; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            return getBucketLowerBound(i);
+        }
+    }
+    return max;
+}
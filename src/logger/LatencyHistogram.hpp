@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace logger {
+// Log-linear histogram in HDR style: exact values below 16, then 8 sub-buckets per power of two (~12% precision).
+// Values above 2^40 ns (~18 minutes) are counted in last bucket
+class LatencyHistogram
+{
+public:
+    static constexpr uint32_t kSubBucketBits     = 3;
+    static constexpr uint32_t kSubBucketsCount   = 1U << kSubBucketBits;
+    static constexpr uint32_t kExactBucketsCount = kSubBucketsCount * 2;
+    static constexpr uint32_t kMaxValueBits      = 40;
+    static constexpr uint32_t kBucketsCount = kExactBucketsCount + (kMaxValueBits - kSubBucketBits - 1) * kSubBucketsCount;
+
+    struct Snapshot
+    {
+        std::array<uint64_t, kBucketsCount> counts{};
+        uint64_t count = 0;
+        uint64_t sum   = 0;
+        uint64_t max   = 0;
+
+        // Returns lower bound of bucket where requested percentile (0-100) lies
+        uint64_t getPercentile(double percentile) const noexcept;
+
+        uint64_t getMean() const noexcept
+        {
+            return count == 0 ? 0 : sum / count;
+        }
+    };
+
+    // Called only by backend thread
+    void record(uint64_t value) noexcept;
+
+    Snapshot load() const noexcept;
+
+    static uint32_t getBucketIndex(uint64_t value) noexcept;
+    static uint64_t getBucketLowerBound(uint32_t index) noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketsCount> m_counts{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+}  // namespace logger
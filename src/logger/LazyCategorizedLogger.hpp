@@ -0,0 +1,196 @@
+﻿#pragma once
+
+#include <quill/sinks/NullSink.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Frontend.hpp"
+
+namespace logger {
+struct InitOptions
+{
+    std::string settingsFileName = "LogSettings.ini";
+
+    // Without backend messages are kept in frontend queues of threads until backend is started
+    bool startBackend = true;
+};
+
+// What lazy logger module does with messages logged before init()
+enum class PreInitPolicy : uint8_t
+{
+    Init,    // First use initializes module with default options
+    Buffer,  // First use creates loggers, messages wait in queues until init() starts backend
+    Drop,    // Messages are dropped and counted
+};
+
+// Logger module constructed on first use or by explicit init() instead of static initialization. Object itself is
+// constant initialized, so it can be used from other static initializers. After initialization each access costs one
+// acquire load
+template <class TLogger>
+class LazyCategorizedLogger
+{
+public:
+    using BaseCategory = typename TLogger::BaseCategory;
+    using CategoryEnum = typename TLogger::CategoryEnum;
+
+    constexpr explicit LazyCategorizedLogger(PreInitPolicy policy) noexcept : m_policy(policy)
+    {
+    }
+
+    // Initializes module once. Starts backend of module created by Buffer policy. Module created before reads default
+    // settings file, other settings file of options is reported as error by internal logger
+    TLogger& init(InitOptions options = {})
+    {
+        std::lock_guard lock(m_initMutex);
+        if (m_owner == nullptr)
+        {
+            m_owner = std::make_unique<TLogger>(std::move(options));
+            m_created.store(m_owner.get(), std::memory_order_release);
+        }
+        else
+        {
+            m_owner->reportIgnoredInitOptions(options);
+            if (options.startBackend && !m_owner->isBackendStarted())
+            {
+                m_owner->startBackend();
+            }
+        }
+
+        m_logger.store(m_owner.get(), std::memory_order_release);
+        return *m_owner;
+    }
+
+    bool isInitialized() const noexcept
+    {
+        return m_logger.load(std::memory_order_acquire) != nullptr;
+    }
+
+    // Initializes module with default options, if it is not initialized yet
+    TLogger& get()
+    {
+        auto* initializedLogger = m_logger.load(std::memory_order_acquire);
+        return initializedLogger != nullptr ? *initializedLogger : init();
+    }
+
+    static constexpr std::string_view getName()
+    {
+        return TLogger::getName();
+    }
+
+    static constexpr size_t getCategoriesCount()
+    {
+        return TLogger::getCategoriesCount();
+    }
+
+    uint64_t getPreInitDroppedMessages() const noexcept
+    {
+        return m_preInitDroppedMessages.load(std::memory_order_relaxed);
+    }
+
+    // Used by logging defines
+    logger::Logger* getLogger(const BaseCategory name)
+    {
+        auto* usableLogger = getUsableLogger();
+        return usableLogger != nullptr ? usableLogger->getLogger(name) : getDisabledLogger();
+    }
+
+    bool isEnabled(const BaseCategory name, quill::LogLevel logLevel)
+    {
+        auto* usableLogger = getUsableLogger();
+        return usableLogger != nullptr && usableLogger->isEnabled(name, logLevel);
+    }
+
+    bool canEnqueue(const BaseCategory name, quill::LogLevel logLevel)
+    {
+        auto* usableLogger = getUsableLogger();
+        if (usableLogger == nullptr)
+        {
+            m_preInitDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return usableLogger->canEnqueue(name, logLevel);
+    }
+
+    bool initBacktrace(const BaseCategory name)
+    {
+        auto* usableLogger = getUsableLogger();
+        return usableLogger != nullptr && usableLogger->initBacktrace(name);
+    }
+
+    double getSampleRate(const BaseCategory name)
+    {
+        auto* usableLogger = getUsableLogger();
+        return usableLogger != nullptr ? usableLogger->getSampleRate(name) : 0.0;
+    }
+
+    uint64_t getSampleThreshold(const BaseCategory name)
+    {
+        auto* usableLogger = getUsableLogger();
+        return usableLogger != nullptr ? usableLogger->getSampleThreshold(name) : 0;
+    }
+
+private:
+    // Module which logging defines may use now, nullptr if messages are dropped
+    TLogger* getUsableLogger()
+    {
+        auto* initializedLogger = m_logger.load(std::memory_order_acquire);
+        if (initializedLogger != nullptr)
+        {
+            return initializedLogger;
+        }
+
+        switch (m_policy)
+        {
+        case PreInitPolicy::Init:
+            return &init();
+        case PreInitPolicy::Buffer:
+        {
+            auto* createdLogger = m_created.load(std::memory_order_acquire);
+            return createdLogger != nullptr ? createdLogger : &createWithoutBackend();
+        }
+        case PreInitPolicy::Drop:
+            break;
+        }
+        return nullptr;
+    }
+
+    TLogger& createWithoutBackend()
+    {
+        std::lock_guard lock(m_initMutex);
+        if (m_owner == nullptr)
+        {
+            m_owner = std::make_unique<TLogger>(InitOptions{.startBackend = false});
+            m_created.store(m_owner.get(), std::memory_order_release);
+        }
+        return *m_owner;
+    }
+
+    // Logger which never logs, returned to defines which take logger before checking canEnqueue
+    static logger::Logger* getDisabledLogger()
+    {
+        static auto* disabledLogger = []()
+        {
+            const auto name = std::string(TLogger::getName()) + kDisabledLoggerNameSuffix.data();
+
+            auto* createdLogger = Frontend::create_or_get_logger(name, Frontend::create_or_get_sink<quill::NullSink>(name));
+            createdLogger->set_log_level(quill::LogLevel::None);
+            return createdLogger;
+        }();
+        return disabledLogger;
+    }
+
+    static constexpr std::string_view kDisabledLoggerNameSuffix = ".PreInit";
+
+    // Module after init() and module created by first message. Messages before init() take module without locking
+    std::atomic<TLogger*> m_logger{nullptr};
+    std::atomic<TLogger*> m_created{nullptr};
+    std::unique_ptr<TLogger> m_owner;
+    std::mutex m_initMutex;
+    std::atomic<uint64_t> m_preInitDroppedMessages{0};
+    PreInitPolicy m_policy;
+};
+}  // namespace logger
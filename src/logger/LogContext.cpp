@@ -0,0 +1,256 @@
+﻿#include "LogContext.hpp"
+
+#include <quill/LogMacros.h>
+#include <quill/sinks/Sink.h>
+
+#include <atomic>
+#include <map>
+
+#include "Frontend.hpp"
+#include "TaskContext.hpp"
+
+namespace {
+constexpr std::string_view kContextLoggerName     = "LogContext";
+constexpr std::string_view kTaskContextLoggerName = "TaskContext";
+
+using BackendContexts = std::map<std::string, std::string, std::less<>>;
+
+// Contexts of threads by thread ID. Used only by backend thread, and it may run during static destruction
+BackendContexts& getBackendContexts()
+{
+    static auto* contexts = new BackendContexts;
+    return *contexts;
+}
+
+BackendContexts& getBackendTaskContexts()
+{
+    static auto* contexts = new BackendContexts;
+    return *contexts;
+}
+
+std::string_view findBackendContext(const BackendContexts& contexts, std::string_view threadId)
+{
+    if (contexts.empty())
+    {
+        return {};
+    }
+
+    const auto it = contexts.find(threadId);
+    return it != contexts.end() ? std::string_view(it->second) : std::string_view{};
+}
+
+// Receives context changes of threads. Change and messages of thread pass same frontend queue, so change is applied
+// before messages logged after it
+class LogContextSink final : public quill::Sink
+{
+public:
+    explicit LogContextSink(BackendContexts& contexts) : m_contexts(contexts)
+    {
+    }
+
+    void write_log(quill::MacroMetadata const* /*logMetadata*/, uint64_t /*logTimestamp*/, std::string_view threadId,
+        std::string_view /*threadName*/, std::string const& /*processId*/, std::string_view /*loggerName*/,
+        quill::LogLevel /*logLevel*/, std::string_view /*logLevelDescription*/, std::string_view /*logLevelShortCode*/,
+        std::vector<std::pair<std::string, std::string>> const* /*namedArgs*/, std::string_view logMessage,
+        std::string_view /*logStatement*/) override
+    {
+        auto& contexts = m_contexts;
+        if (logMessage.empty())
+        {
+            const auto it = contexts.find(threadId);
+            if (it != contexts.end())
+            {
+                contexts.erase(it);
+            }
+            return;
+        }
+
+        const auto it = contexts.find(threadId);
+        if (it != contexts.end())
+        {
+            it->second.assign(logMessage);
+        }
+        else
+        {
+            contexts.emplace(std::string(threadId), std::string(logMessage));
+        }
+    }
+
+    void flush_sink() override
+    {
+    }
+
+private:
+    BackendContexts& m_contexts;
+};
+
+logger::Logger* createContextLogger(std::string_view loggerName, BackendContexts& contexts)
+{
+    const auto name     = std::string(loggerName);
+    auto* createdLogger =
+        logger::Frontend::create_or_get_logger(name, logger::Frontend::create_or_get_sink<LogContextSink>(name, contexts));
+    createdLogger->set_log_level(quill::LogLevel::TraceL3);
+    return createdLogger;
+}
+
+logger::Logger* getContextLogger()
+{
+    static auto* contextLogger = createContextLogger(kContextLoggerName, getBackendContexts());
+    return contextLogger;
+}
+
+logger::Logger* getTaskContextLogger()
+{
+    static auto* taskContextLogger = createContextLogger(kTaskContextLoggerName, getBackendTaskContexts());
+    return taskContextLogger;
+}
+
+void sendContext(const logger::LogContext& context)
+{
+    QUILL_LOG_INFO(getContextLogger(), "{}", context.text);
+}
+
+// Backend keeps context by thread ID, which may be reused by new thread, so context is cleared when thread exits
+struct ThreadContext
+{
+    ThreadContext()
+    {
+        // Queue of thread is created first, so it is destroyed after this object and can take last message
+        logger::Frontend::preallocate();
+    }
+
+    ~ThreadContext()
+    {
+        if (!context.text.empty())
+        {
+            sendContext(logger::LogContext{});
+        }
+    }
+
+    logger::LogContext context;
+};
+
+logger::LogContext& getThreadContext()
+{
+    thread_local ThreadContext threadContext;
+    return threadContext.context;
+}
+
+void updateText(logger::LogContext& context)
+{
+    context.text.clear();
+    for (const auto& field : context.fields)
+    {
+        if (!context.text.empty())
+        {
+            context.text += ' ';
+        }
+        context.text += field.key;
+        context.text += '=';
+        context.text += field.value;
+    }
+}
+}  // namespace
+
+const logger::LogContext& logger::getLogContext()
+{
+    return getThreadContext();
+}
+
+void logger::pushLogContext(std::string_view key, std::string_view value)
+{
+    auto& context = getThreadContext();
+    context.fields.push_back(LogContextField{std::string(key), std::string(value)});
+    updateText(context);
+    sendContext(context);
+}
+
+void logger::popLogContext()
+{
+    auto& context = getThreadContext();
+    if (context.fields.empty())
+    {
+        return;
+    }
+
+    context.fields.pop_back();
+    updateText(context);
+    sendContext(context);
+}
+
+logger::LogContext logger::exchangeLogContext(LogContext context)
+{
+    auto& current = getThreadContext();
+    std::swap(current, context);
+    if (current.text != context.text)
+    {
+        sendContext(current);
+    }
+    return context;
+}
+
+std::string_view logger::detail::getBackendLogContext(std::string_view threadId)
+{
+    return findBackendContext(getBackendContexts(), threadId);
+}
+
+logger::TaskContext logger::TaskContext::create(uint64_t parentSpanId) noexcept
+{
+    static std::atomic<uint64_t> lastTaskId{0};
+    return TaskContext{lastTaskId.fetch_add(1, std::memory_order_relaxed) + 1, parentSpanId};
+}
+
+// IDs are formatted by backend, so frontend encodes only two integers
+void logger::detail::sendTaskContext()
+{
+    // Backend keeps task context by thread ID, which may be reused by new thread, so it is cleared when thread exits
+    struct ThreadExit
+    {
+        ThreadExit()
+        {
+            // Queue of thread is created first, so it is destroyed after this object and can take last message
+            logger::Frontend::preallocate();
+        }
+
+        ~ThreadExit()
+        {
+            auto& state = t_taskContextState;
+            if (state.sent != nullptr)
+            {
+                state.current = nullptr;
+                logTaskContext(state);
+            }
+        }
+    };
+    thread_local ThreadExit threadExit;
+
+    logTaskContext(t_taskContextState);
+}
+
+void logger::detail::logTaskContext(TaskContextThreadState& state)
+{
+    state.sent = state.current;
+    if (state.current == nullptr)
+    {
+        state.sentTaskId       = 0;
+        state.sentParentSpanId = 0;
+        QUILL_LOG_INFO(getTaskContextLogger(), "");
+        return;
+    }
+
+    state.sentTaskId       = state.current->taskId;
+    state.sentParentSpanId = state.current->parentSpanId;
+    if (state.sentParentSpanId == 0)
+    {
+        QUILL_LOG_INFO(getTaskContextLogger(), "task={}", state.sentTaskId);
+    }
+    else
+    {
+        QUILL_LOG_INFO(getTaskContextLogger(), "task={} parent={}", state.sentTaskId, state.sentParentSpanId);
+    }
+}
+
+std::string_view logger::detail::getBackendTaskContext(std::string_view threadId)
+{
+    return findBackendContext(getBackendTaskContexts(), threadId);
+}
@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace logger {
+struct LogContextField
+{
+    std::string key;
+    std::string value;
+};
+
+// Mapped diagnostic context of thread, e.g. request and session IDs. Each change of context is sent to backend once,
+// in queue of thread, so backend knows context of each following message of thread without it being encoded per
+// message. Context is written as "[key=value ...]" after category column
+struct LogContext
+{
+    std::vector<LogContextField> fields;
+    std::string text;  // Fields in rendered form
+};
+
+// Context of calling thread
+const LogContext& getLogContext();
+
+void pushLogContext(std::string_view key, std::string_view value);
+void popLogContext();
+
+// Replaces context of calling thread, returns previous one
+LogContext exchangeLogContext(LogContext context);
+
+// Field of context of calling thread for scope
+class ScopedLogContext
+{
+public:
+    ScopedLogContext(std::string_view key, std::string_view value)
+    {
+        pushLogContext(key, value);
+    }
+
+    template <class T>
+        requires std::is_arithmetic_v<T>
+    ScopedLogContext(std::string_view key, T value)
+    {
+        pushLogContext(key, std::to_string(value));
+    }
+
+    ~ScopedLogContext()
+    {
+        popLogContext();
+    }
+
+    ScopedLogContext(const ScopedLogContext&)            = delete;
+    ScopedLogContext& operator=(const ScopedLogContext&) = delete;
+};
+
+// Context captured on one thread and used on other for scope, e.g. by task of executor
+class ScopedLogContextHandoff
+{
+public:
+    explicit ScopedLogContextHandoff(LogContext context) : m_previous(exchangeLogContext(std::move(context)))
+    {
+    }
+
+    ~ScopedLogContextHandoff()
+    {
+        exchangeLogContext(std::move(m_previous));
+    }
+
+    ScopedLogContextHandoff(const ScopedLogContextHandoff&)            = delete;
+    ScopedLogContextHandoff& operator=(const ScopedLogContextHandoff&) = delete;
+
+private:
+    LogContext m_previous;
+};
+
+// Task which runs function with context of thread which created the task
+template <class TFunction>
+auto bindLogContext(TFunction&& function)
+{
+    return [context = getLogContext(), function = std::forward<TFunction>(function)]() mutable -> decltype(auto)
+    {
+        ScopedLogContextHandoff handoff(context);
+        return function();
+    };
+}
+
+namespace detail {
+// Called only by backend thread. Empty if thread has no context
+std::string_view getBackendLogContext(std::string_view threadId);
+}  // namespace detail
+}  // namespace logger
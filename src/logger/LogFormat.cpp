@@ -0,0 +1,111 @@
+﻿#include "LogFormat.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+namespace {
+// Bare function name as __FUNCTION__ of quill macros gives it, std::source_location gives whole signature, e.g.
+// "void ns::Class::run(int) [with T = int]" is "run"
+std::string getFunctionName(std::string_view signature)
+{
+    const auto templateArguments = signature.find(" [with ");
+    if (templateArguments != std::string_view::npos)
+    {
+        signature = signature.substr(0, templateArguments);
+    }
+    if (!signature.ends_with(')'))
+    {
+        return std::string(signature);
+    }
+
+    // Parameters are last parenthesized part
+    size_t depth = 0;
+    size_t end   = signature.size();
+    while (end > 0)
+    {
+        const char c = signature[--end];
+        depth += c == ')' ? 1 : 0;
+        if (c == '(' && --depth == 0)
+        {
+            break;
+        }
+    }
+
+    // Return type is before last space and scope is before last "::", both outside of template arguments
+    depth        = 0;
+    size_t begin = end;
+    while (begin > 0)
+    {
+        const char c = signature[begin - 1];
+        if (c == '>')
+        {
+            ++depth;
+        }
+        else if (c == '<' && depth > 0)
+        {
+            --depth;
+        }
+        else if (depth == 0 && (c == ' ' || c == ':'))
+        {
+            break;
+        }
+        --begin;
+    }
+
+    // Template arguments of function template
+    auto name                    = signature.substr(begin, end - begin);
+    const auto templateArgsBegin = name.find('<');
+    if (name.ends_with('>') && templateArgsBegin != std::string_view::npos && !name.starts_with("operator"))
+    {
+        name = name.substr(0, templateArgsBegin);
+    }
+    return std::string(name);
+}
+
+// Metadata refers to location and function strings, so they are kept together at stable address
+struct CallSite
+{
+    CallSite(const logger::LogFormat& format, quill::LogLevel logLevel)
+        : location(std::string(format.file) + ':' + std::to_string(format.line)),
+          function(getFunctionName(format.function)),
+          metadata(location.c_str(), function.c_str(), format.format, nullptr, logLevel, quill::MacroMetadata::Event::Log)
+    {
+    }
+
+    std::string location;
+    std::string function;
+    quill::MacroMetadata metadata;
+};
+
+using CallSiteKey = std::tuple<const char*, const char*, uint32_t, quill::LogLevel>;
+
+struct CallSitesState
+{
+    std::mutex mutex;
+    std::map<CallSiteKey, std::unique_ptr<CallSite>> callSites;
+};
+
+// Statements may be logged during static initialization, and backend may read metadata during static destruction
+CallSitesState& getCallSitesState()
+{
+    static auto* state = new CallSitesState;
+    return *state;
+}
+}  // namespace
+
+quill::MacroMetadata const* logger::detail::registerCallSite(const LogFormat& format, quill::LogLevel logLevel)
+{
+    auto& state = getCallSitesState();
+    std::lock_guard lock(state.mutex);
+
+    auto& callSite = state.callSites[CallSiteKey{format.format, format.file, format.line, logLevel}];
+    if (callSite == nullptr)
+    {
+        callSite = std::make_unique<CallSite>(format, logLevel);
+    }
+    return &callSite->metadata;
+}
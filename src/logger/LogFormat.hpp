@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <quill/core/LogLevel.h>
+#include <quill/core/MacroMetadata.h>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <source_location>
+
+namespace logger {
+// Format string of log statement with its call site. Constructed at compile time from string literal, so call site is
+// taken from std::source_location instead of macros
+struct LogFormat
+{
+    template <size_t N>
+    consteval LogFormat(const char (&format)[N], std::source_location location = std::source_location::current()) noexcept
+        : format(format), file(location.file_name()), function(location.function_name()), line(location.line())
+    {
+    }
+
+    const char* format;
+    const char* file;
+    const char* function;
+    uint32_t line;
+};
+
+namespace detail {
+struct CallSiteCacheEntry
+{
+    const char* format                   = nullptr;
+    const char* file                     = nullptr;
+    uint32_t line                        = 0;
+    quill::LogLevel logLevel             = quill::LogLevel::None;
+    quill::MacroMetadata const* metadata = nullptr;
+};
+
+quill::MacroMetadata const* registerCallSite(const LogFormat& format, quill::LogLevel logLevel);
+}  // namespace detail
+
+// Metadata of call site, it lives until process exit, as metadata of quill macros does. Call sites are cached by
+// thread, so usual cost is one multiplication and few compares, slow path takes process wide lock once per call site and level
+inline quill::MacroMetadata const* getCallSiteMetadata(const LogFormat& format, quill::LogLevel logLevel)
+{
+    constexpr size_t kCacheSize     = 64;
+    constexpr int kCacheShift       = 64 - std::countr_zero(kCacheSize);
+    constexpr uint64_t kGoldenRatio = 0x9E3779B97F4A7C15ULL;
+
+    thread_local std::array<detail::CallSiteCacheEntry, kCacheSize> cache{};
+
+    const auto hash = (reinterpret_cast<uintptr_t>(format.format) ^ format.line ^ static_cast<uint64_t>(logLevel)) * kGoldenRatio;
+    auto& entry     = cache[hash >> kCacheShift];
+    if (entry.format != format.format || entry.file != format.file || entry.line != format.line || entry.logLevel != logLevel)
+    {
+        entry = detail::CallSiteCacheEntry{
+            format.format, format.file, format.line, logLevel, detail::registerCallSite(format, logLevel)};
+    }
+    return entry.metadata;
+}
+}  // namespace logger
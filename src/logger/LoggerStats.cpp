@@ -0,0 +1,79 @@
+﻿#include "LoggerStats.hpp"
+
+#include <quill/Backend.h>
+
+#include "QueueBudget.hpp"
+
+#include <charconv>
+#include <iostream>
+#include <optional>
+
+// Notifications below are formatted by quill backend worker, their text has to be checked on quill update
+static_assert(quill::VersionMajor == 10, "Check notification texts of quill backend parsed by onBackendNotification");
+
+namespace {
+// "<time> Quill INFO: Dropped <count> log messages from thread <id>"
+constexpr std::string_view kDroppedNotification = "Quill INFO: Dropped ";
+
+// "<time> Quill INFO: Experienced <count> blocking occurrences on thread <id>"
+constexpr std::string_view kBlockedNotification = "Quill INFO: Experienced ";
+
+struct QueueCounters
+{
+    std::atomic<uint64_t> droppedMessages{0};
+    std::atomic<uint64_t> blockedEnqueues{0};
+};
+
+QueueCounters& getQueueCounters() noexcept
+{
+    static QueueCounters counters;
+    return counters;
+}
+
+// Count which directly follows prefix of notification, nullopt if message is other notification
+std::optional<uint64_t> parseNotificationCount(std::string_view message, std::string_view prefix) noexcept
+{
+    const auto pos = message.find(prefix);
+    if (pos == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+
+    const auto* begin = message.data() + pos + prefix.size();
+    const auto* end   = message.data() + message.size();
+
+    uint64_t value = 0;
+
+    const auto [ptr, errorCode] = std::from_chars(begin, end, value);
+    if (errorCode != std::errc() || ptr == end || *ptr != ' ')
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+}  // namespace
+
+logger::QueueStats logger::getQueueStats() noexcept
+{
+    const auto& counters = getQueueCounters();
+    return QueueStats{counters.droppedMessages.load(std::memory_order_relaxed),
+        counters.blockedEnqueues.load(std::memory_order_relaxed), getQueueMemoryStats()};
+}
+
+void logger::onBackendNotification(std::string const& message)
+{
+    auto& counters = getQueueCounters();
+    const std::string_view view(message);
+
+    if (const auto dropped = parseNotificationCount(view, kDroppedNotification))
+    {
+        incrementCounter(counters.droppedMessages, *dropped);
+    }
+    else if (const auto blocked = parseNotificationCount(view, kBlockedNotification))
+    {
+        incrementCounter(counters.blockedEnqueues, *blocked);
+    }
+
+    // Same output as quill default notifier
+    std::cerr << message << std::endl;
+}
@@ -0,0 +1,129 @@
+﻿#pragma once
+
+#include <quill/core/LogLevel.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CallSiteProfiler.hpp"
+#include "LatencyHistogram.hpp"
+
+namespace logger {
+inline constexpr size_t kLogLevelsCount = static_cast<size_t>(quill::LogLevel::None);
+
+struct SinkStats
+{
+    uint64_t writtenMessages   = 0;
+    uint64_t filteredMessages  = 0;
+    uint64_t writtenBytes      = 0;
+    uint64_t coalescedMessages = 0;
+};
+
+struct CategoryStats
+{
+    std::string_view name;
+    std::array<uint64_t, kLogLevelsCount> messagesByLevel{};
+    SinkStats file;
+    SinkStats console;
+};
+
+// Time spent by constructor of logger module in nanoseconds. Sinks part includes creation of loggers
+struct StartupProfile
+{
+    uint64_t loadSettingsNs = 0;
+    uint64_t sinksNs        = 0;
+    uint64_t backendStartNs = 0;
+};
+
+// Memory of frontend queues of all threads and actions taken by queue memory budget
+struct QueueMemoryStats
+{
+    uint64_t currentBytes    = 0;
+    uint64_t peakBytes       = 0;
+    uint64_t budgetBytes     = 0;
+    uint64_t droppedMessages = 0;
+    uint64_t blockedMessages = 0;
+    uint64_t shrunkQueues    = 0;
+
+    // Largest capacity of queue of one thread, i.e. memory allocated for it. It is not peak fill of queue, quill
+    // doesn't expose how many bytes were queued. Capacity is read by logging thread every few messages for queue
+    // budget, so growth is seen with that lag and growth right before thread exit may be missed
+    uint64_t largestQueueBytes = 0;
+};
+
+// Frontend queues are per thread and shared by all modules, so these counters are process wide. Dropped and blocked
+// counts are parsed from text of quill backend notifications, see onBackendNotification
+struct QueueStats
+{
+    uint64_t droppedMessages = 0;
+    uint64_t blockedEnqueues = 0;
+    QueueMemoryStats memory;
+};
+
+// Latencies in nanoseconds since start. Queue latency is time from log call (message timestamp) until backend passes
+// message to sinks. Write latency is time spent by sink to write message
+struct CategoryLatencyStats
+{
+    std::string_view name;
+    LatencyHistogram::Snapshot queue;
+    LatencyHistogram::Snapshot fileWrite;
+    LatencyHistogram::Snapshot consoleWrite;
+};
+
+// Static categories of module followed by its dynamic ones, latencies are in same order as categories
+struct ModuleStats
+{
+    std::string_view name;
+    std::vector<CategoryStats> categories;
+    std::vector<CategoryLatencyStats> latencies;
+};
+
+template <size_t CategoriesCount>
+struct LoggerStats
+{
+    std::array<CategoryStats, CategoriesCount> categories;
+    QueueStats queues;
+};
+
+// All counters below have single writer - backend thread. Producers never touch them
+inline void incrementCounter(std::atomic<uint64_t>& counter, uint64_t value = 1) noexcept
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+struct SinkCounters
+{
+    std::atomic<uint64_t> writtenMessages{0};
+    std::atomic<uint64_t> filteredMessages{0};
+    std::atomic<uint64_t> writtenBytes{0};
+    std::atomic<uint64_t> coalescedMessages{0};
+
+    SinkStats load() const noexcept
+    {
+        return SinkStats{writtenMessages.load(std::memory_order_relaxed), filteredMessages.load(std::memory_order_relaxed),
+            writtenBytes.load(std::memory_order_relaxed), coalescedMessages.load(std::memory_order_relaxed)};
+    }
+};
+
+struct alignas(64) CategoryCounters
+{
+    std::array<std::atomic<uint64_t>, kLogLevelsCount> messagesByLevel{};
+    LatencyHistogram queueLatency;
+    CallSiteProfiler callSites;
+};
+
+QueueStats getQueueStats() noexcept;
+
+// Used as quill::BackendOptions::error_notifier. Quill reports dropped and blocked enqueues only as text messages from
+// backend thread: per thread failure counters are read and reset by backend itself, so they can't be read here.
+// Limits of parsing:
+// - Texts are those of quill 10, which is checked by static_assert. Other quill version fails to build until texts
+//   are checked, instead of counting zero silently
+// - Only counts which quill reported reach these stats. Backend reports them when it sees failures of thread, so
+//   failures of last moments before exit may be missing
+void onBackendNotification(std::string const& message);
+}  // namespace logger
@@ -0,0 +1,125 @@
+﻿#include "ModuleRegistry.hpp"
+
+#include <quill/sinks/FileSink.h>
+
+#include <algorithm>
+
+#include "Frontend.hpp"
+#include "ObservedSink.hpp"
+#include "QueueBudget.hpp"
+
+namespace {
+constexpr std::string_view kLogFileName        = "logs/log.txt";
+constexpr std::string_view kPatternLogFileName = "_%d_%m_%Y_%H_%M_%S";
+}  // namespace
+
+void logger::ModuleRegistry::addModule(ModuleEntry entry)
+{
+    std::lock_guard lock(m_modulesMutex);
+    m_modules.push_back(std::move(entry));
+}
+
+void logger::ModuleRegistry::removeModule(const void* module)
+{
+    std::lock_guard lock(m_modulesMutex);
+    std::erase_if(m_modules, [module](const ModuleEntry& entry) { return entry.module == module; });
+}
+
+std::vector<std::string_view> logger::ModuleRegistry::getModuleNames() const
+{
+    std::lock_guard lock(m_modulesMutex);
+
+    std::vector<std::string_view> names;
+    names.reserve(m_modules.size());
+    for (const auto& entry : m_modules)
+    {
+        names.push_back(entry.name);
+    }
+    return names;
+}
+
+std::vector<logger::ModuleStats> logger::ModuleRegistry::getStats() const
+{
+    std::lock_guard lock(m_modulesMutex);
+
+    std::vector<ModuleStats> stats;
+    stats.reserve(m_modules.size());
+    for (const auto& entry : m_modules)
+    {
+        stats.push_back(entry.getStats());
+    }
+    return stats;
+}
+
+bool logger::ModuleRegistry::setLogLevel(
+    std::string_view module, std::string_view category, LogSink sink, quill::LogLevel logLevel) const
+{
+    std::lock_guard lock(m_modulesMutex);
+
+    const auto it = std::ranges::find(m_modules, module, &ModuleEntry::name);
+    return it != m_modules.end() && it->setLogLevel(category, sink, logLevel);
+}
+
+std::string& logger::ModuleRegistry::getSettingsContent(const std::string& fileName)
+{
+    auto it = m_settingsFiles.find(fileName);
+    if (it == m_settingsFiles.end())
+    {
+        const MappedFile settingsFile(fileName);
+        it = m_settingsFiles.emplace(fileName, std::string(settingsFile.getContent())).first;
+    }
+    return it->second;
+}
+
+std::shared_ptr<quill::Sink> logger::ModuleRegistry::getFileSink()
+{
+    std::lock_guard lock(m_fileSinkMutex);
+    if (m_fileSink == nullptr)
+    {
+        quill::FileSinkConfig cfg;
+        cfg.set_open_mode('w');
+        cfg.set_filename_append_option(quill::FilenameAppendOption::StartCustomTimestampFormat, kPatternLogFileName);
+
+        m_fileSink = Frontend::create_or_get_sink<ObservedSink<quill::FileSink>>(kLogFileName.data(), std::move(cfg));
+
+        // File sink is shared by all modules, so budget of queues is updated by its periodic task once per process
+        auto* observedSink = dynamic_cast<ObservedSink<quill::FileSink>*>(m_fileSink.get());
+        if (observedSink != nullptr)
+        {
+            observedSink->getRouter().addPeriodicTask(&detail::updateQueueBudget);
+        }
+    }
+    return m_fileSink;
+}
+
+bool logger::ModuleRegistry::startBackend(std::string_view moduleName, const quill::BackendOptions& options)
+{
+    std::lock_guard lock(m_backendMutex);
+    if (!m_backendOwner.empty())
+    {
+        return false;
+    }
+
+    quill::Backend::start(options);
+    m_backendOwner = moduleName;
+    return true;
+}
+
+bool logger::ModuleRegistry::isBackendStarted() const
+{
+    std::lock_guard lock(m_backendMutex);
+    return !m_backendOwner.empty();
+}
+
+std::string logger::ModuleRegistry::getBackendOwner() const
+{
+    std::lock_guard lock(m_backendMutex);
+    return m_backendOwner;
+}
+
+// Leaked, since constant initialized lazy modules are destroyed after function local statics and remove themselves
+logger::ModuleRegistry& logger::getModuleRegistry()
+{
+    static auto* registry = new ModuleRegistry;
+    return *registry;
+}
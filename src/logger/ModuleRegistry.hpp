@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <quill/Backend.h>
+#include <quill/sinks/Sink.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LoggerStats.hpp"
+#include "SettingsFile.hpp"
+
+namespace logger {
+enum class LogSink : uint8_t
+{
+    File,
+    Console
+};
+
+// Registered logger module, independent of its category type
+struct ModuleEntry
+{
+    const void* module = nullptr;
+    std::string_view name;
+    std::function<ModuleStats()> getStats;
+
+    // False if module has no such category
+    std::function<bool(std::string_view category, LogSink sink, quill::LogLevel logLevel)> setLogLevel;
+};
+
+// Process wide state shared by logger modules: settings files, log file sink and backend. Also one view of all
+// modules for level control and statistics
+class ModuleRegistry
+{
+public:
+    void addModule(ModuleEntry entry);
+    void removeModule(const void* module);
+
+    std::vector<std::string_view> getModuleNames() const;
+    std::vector<ModuleStats> getStats() const;
+
+    // Runtime level of sink of category, settings file is not changed. False if module or category is not found
+    bool setLogLevel(std::string_view module, std::string_view category, LogSink sink, quill::LogLevel logLevel) const;
+
+    // Settings file is read from disk once per process, modules apply it from memory. Update receives content and
+    // returns new content, which is written to file, or empty string if content is up to date
+    template <class TUpdate>
+    void updateSettings(const std::string& fileName, TUpdate&& update)
+    {
+        std::lock_guard lock(m_settingsMutex);
+
+        auto& content   = getSettingsContent(fileName);
+        auto newContent = update(std::string_view(content));
+        if (!newContent.empty())
+        {
+            content = std::move(newContent);
+            replaceFileContent(fileName, content);
+        }
+    }
+
+    // All modules write to one file sink, messages of categories are told apart by logger name
+    std::shared_ptr<quill::Sink> getFileSink();
+
+    // Backend is started once by first module which asks for it. False if it is already started
+    bool startBackend(std::string_view moduleName, const quill::BackendOptions& options);
+    bool isBackendStarted() const;
+    std::string getBackendOwner() const;
+
+private:
+    std::string& getSettingsContent(const std::string& fileName);
+
+    mutable std::mutex m_modulesMutex;
+    std::vector<ModuleEntry> m_modules;
+
+    std::mutex m_settingsMutex;
+    std::map<std::string, std::string, std::less<>> m_settingsFiles;
+
+    std::mutex m_fileSinkMutex;
+    std::shared_ptr<quill::Sink> m_fileSink;
+
+    mutable std::mutex m_backendMutex;
+    std::string m_backendOwner;
+};
+
+// Created on first use, so it is available to logger modules constructed during static initialization
+ModuleRegistry& getModuleRegistry();
+}  // namespace logger
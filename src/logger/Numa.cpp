@@ -0,0 +1,87 @@
+﻿#include "Numa.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr std::string_view kNodesPath      = "/sys/devices/system/node";
+constexpr std::string_view kNodeDirPrefix = "node";
+
+// Parses kernel cpu list format, e.g. "0-3,8-11"
+std::vector<uint16_t> parseCpuList(std::string_view cpuList)
+{
+    std::vector<uint16_t> cpus;
+    while (!cpuList.empty())
+    {
+        const auto rangeEnd = cpuList.find(',');
+        const auto range    = cpuList.substr(0, rangeEnd);
+        cpuList             = rangeEnd == std::string_view::npos ? std::string_view{} : cpuList.substr(rangeEnd + 1);
+
+        uint16_t first = 0;
+        const auto [firstEnd, firstError] = std::from_chars(range.data(), range.data() + range.size(), first);
+        if (firstError != std::errc{})
+        {
+            continue;
+        }
+
+        uint16_t last = first;
+        if (firstEnd != range.data() + range.size() && *firstEnd == '-')
+        {
+            std::from_chars(firstEnd + 1, range.data() + range.size(), last);
+        }
+
+        for (uint32_t cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(static_cast<uint16_t>(cpu));
+        }
+    }
+    return cpus;
+}
+}  // namespace
+
+int logger::getNumaNodesCount()
+{
+    std::error_code error;
+    int count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(kNodesPath, error))
+    {
+        const auto name = entry.path().filename().string();
+        if (name.starts_with(kNodeDirPrefix) && name.size() > kNodeDirPrefix.size() &&
+            std::isdigit(static_cast<unsigned char>(name[kNodeDirPrefix.size()])) != 0)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+std::vector<uint16_t> logger::getNumaNodeCpus(int node)
+{
+    std::ifstream cpuListFile(std::string(kNodesPath) + "/" + std::string(kNodeDirPrefix) + std::to_string(node) + "/cpulist");
+
+    std::string cpuList;
+    std::getline(cpuListFile, cpuList);
+    return parseCpuList(cpuList);
+}
+
+int logger::getThisThreadNumaNode() noexcept
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu  = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+    {
+        return static_cast<int>(node);
+    }
+#endif
+    return -1;
+}
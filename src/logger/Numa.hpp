@@ -0,0 +1,13 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace logger {
+// NUMA topology read from sysfs. Linux only, on other systems there are no nodes
+int getNumaNodesCount();
+std::vector<uint16_t> getNumaNodeCpus(int node);
+
+// Node of CPU the calling thread currently runs on, -1 if unknown
+int getThisThreadNumaNode() noexcept;
+}  // namespace logger
@@ -0,0 +1,100 @@
+﻿#include "ObservedSink.hpp"
+
+namespace {
+size_t getCacheIndex(const char* loggerName, size_t cacheSize) noexcept
+{
+    constexpr uint64_t kGoldenRatio = 0x9E3779B97F4A7C15ULL;
+    constexpr uint64_t kHashShift   = 32;
+    return static_cast<size_t>((reinterpret_cast<uintptr_t>(loggerName) * kGoldenRatio) >> kHashShift) % cacheSize;
+}
+}  // namespace
+
+template <class TModifier>
+void logger::SinkRouter::modify(TModifier&& modifier)
+{
+    std::lock_guard lock(m_mutex);
+
+    const auto* current = m_routes.load(std::memory_order_acquire);
+    auto routes         = current != nullptr ? std::make_unique<Routes>(*current) : std::make_unique<Routes>();
+
+    modifier(*routes);
+
+    m_routes.store(routes.get(), std::memory_order_release);
+    const auto version = m_version.load(std::memory_order_relaxed) + 1;
+    m_version.store(version, std::memory_order_release);
+
+    if (m_currentRoutes != nullptr)
+    {
+        m_retiredRoutes.push_back(RetiredRoutes{std::move(m_currentRoutes), version});
+    }
+    m_currentRoutes = std::move(routes);
+
+    const auto backendVersion = m_backendVersion.load(std::memory_order_acquire);
+    std::erase_if(m_retiredRoutes, [backendVersion](const RetiredRoutes& retired) { return retired.version <= backendVersion; });
+}
+
+void logger::SinkRouter::addRoute(std::string_view loggerName, SinkRoute* route, std::shared_ptr<const void> routeOwner)
+{
+    const NamedRoute namedRoute{loggerName, route};
+    addRoutes(std::span(&namedRoute, 1), std::move(routeOwner));
+}
+
+void logger::SinkRouter::addRoutes(std::span<const NamedRoute> namedRoutes, std::shared_ptr<const void> routesOwner)
+{
+    modify(
+        [&](Routes& routes)
+        {
+            // Loggers with same name are the same quill logger, so first registered route is kept
+            for (const auto& [loggerName, route] : namedRoutes)
+            {
+                routes.routes.try_emplace(std::string(loggerName), route);
+            }
+            m_routeOwners.push_back(std::move(routesOwner));
+        });
+}
+
+void logger::SinkRouter::addPeriodicTask(PeriodicTask task)
+{
+    modify([&](Routes& routes) { routes.periodicTasks.push_back(std::move(task)); });
+}
+
+void logger::SinkRouter::runPeriodicTasks()
+{
+    // Quiescent point, tables replaced before seen version are not used by backend anymore
+    m_backendVersion.store(m_version.load(std::memory_order_acquire), std::memory_order_release);
+
+    const auto* routes = m_routes.load(std::memory_order_acquire);
+    if (routes == nullptr)
+    {
+        return;
+    }
+
+    for (const auto& task : routes->periodicTasks)
+    {
+        task();
+    }
+}
+
+logger::SinkRoute* logger::SinkRouter::find(std::string_view loggerName) const noexcept
+{
+    auto& cached = m_cache[getCacheIndex(loggerName.data(), kCacheSize)];
+    if (cached.loggerName == loggerName.data())
+    {
+        return cached.route;
+    }
+
+    const auto* routes = m_routes.load(std::memory_order_acquire);
+    if (routes == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto it = routes->routes.find(loggerName);
+    if (it == routes->routes.end())
+    {
+        return nullptr;
+    }
+
+    cached = CachedRoute{loggerName.data(), it->second};
+    return it->second;
+}
@@ -0,0 +1,381 @@
+﻿#pragma once
+
+#include <quill/sinks/Sink.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogContext.hpp"
+#include "LoggerStats.hpp"
+#include "ScopeTime.hpp"
+#include "TaskContext.hpp"
+
+namespace logger {
+// Consecutive identical messages of route (same call site, formatted message, thread and context) within window are
+// collapsed into first message and "last message repeated N times" line. Everything except window is used only by
+// backend thread
+struct CoalescingState
+{
+    std::atomic<uint64_t> windowNs{0};
+
+    uint64_t lastHash          = 0;
+    uint64_t runStartTimestamp = 0;
+    uint64_t repeats           = 0;
+
+    // Last written message, its pattern is reused for repeat summary line
+    quill::MacroMetadata const* metadata = nullptr;
+    std::string_view loggerName;
+    quill::LogLevel logLevel = quill::LogLevel::None;
+    std::string_view logLevelDescription;
+    std::string_view logLevelShortCode;
+    std::string statement;
+    size_t messageOffset = 0;
+    size_t messageSize   = 0;
+};
+
+// Per category state of one sink. Sinks are shared between categories and modules, so level filtering and
+// accounting are done per route instead of by sink's own level filter
+struct SinkRoute
+{
+    std::atomic<quill::LogLevel> logLevel{quill::LogLevel::TraceL3};
+    SinkCounters counters;
+    LatencyHistogram writeLatency;
+
+    // Set only for one sink of category to count each message once
+    CategoryCounters* category = nullptr;
+
+    CoalescingState coalescing;
+};
+
+// Maps logger name to its route and keeps periodic tasks of modules. Both are added from constructors of modules while
+// backend may already run, so table is replaced as a whole and never modified in place
+class SinkRouter
+{
+public:
+    using PeriodicTask = std::function<void()>;
+    using NamedRoute   = std::pair<std::string_view, SinkRoute*>;
+
+    void addRoute(std::string_view loggerName, SinkRoute* route, std::shared_ptr<const void> routeOwner);
+
+    // Routes table is copied on each change, so routes of all categories of module are added by one copy
+    void addRoutes(std::span<const NamedRoute> namedRoutes, std::shared_ptr<const void> routesOwner);
+    void addPeriodicTask(PeriodicTask task);
+
+    // Called only by backend thread. Backend holds no routes table between calls of runPeriodicTasks, so tables
+    // replaced before its call are freed by next change
+    SinkRoute* find(std::string_view loggerName) const noexcept;
+    void runPeriodicTasks();
+
+    template <class TVisitor>
+    void forEachRoute(TVisitor&& visitor) const
+    {
+        const auto* routes = m_routes.load(std::memory_order_acquire);
+        if (routes == nullptr)
+        {
+            return;
+        }
+
+        for (const auto& [name, route] : routes->routes)
+        {
+            visitor(*route);
+        }
+    }
+
+private:
+    struct Routes
+    {
+        std::map<std::string, SinkRoute*, std::less<>> routes;
+        std::vector<PeriodicTask> periodicTasks;
+    };
+
+    template <class TModifier>
+    void modify(TModifier&& modifier);
+
+    struct CachedRoute
+    {
+        const char* loggerName = nullptr;
+        SinkRoute* route       = nullptr;
+    };
+
+    static constexpr size_t kCacheSize = 16;
+
+    struct RetiredRoutes
+    {
+        std::unique_ptr<const Routes> routes;
+        uint64_t version = 0;  // Version which replaced table
+    };
+
+    std::mutex m_mutex;
+    std::unique_ptr<const Routes> m_currentRoutes;
+    std::vector<RetiredRoutes> m_retiredRoutes;
+    std::vector<std::shared_ptr<const void>> m_routeOwners;
+    std::atomic<const Routes*> m_routes{nullptr};
+
+    // Version of table is published after table, so backend which saw version uses that table or newer one
+    std::atomic<uint64_t> m_version{0};
+    std::atomic<uint64_t> m_backendVersion{0};
+
+    // Logger names passed by backend point to strings owned by loggers, so address identifies logger
+    mutable std::array<CachedRoute, kCacheSize> m_cache{};
+};
+
+template <class TBase>
+class ObservedSink final : public TBase
+{
+public:
+    using TBase::TBase;
+
+    SinkRouter& getRouter() noexcept
+    {
+        return m_router;
+    }
+
+    void write_log(quill::MacroMetadata const* logMetadata, uint64_t logTimestamp, std::string_view threadId,
+        std::string_view threadName, std::string const& processId, std::string_view loggerName, quill::LogLevel logLevel,
+        std::string_view logLevelDescription, std::string_view logLevelShortCode,
+        std::vector<std::pair<std::string, std::string>> const* namedArgs, std::string_view logMessage,
+        std::string_view logStatement) override
+    {
+        const auto scopeDurationNs = getScopeDurationNs(logMetadata, namedArgs);
+        if (scopeDurationNs.has_value())
+        {
+            formatScopeDuration(logStatement, logMessage, *scopeDurationNs);
+        }
+
+        const auto taskContext = detail::getBackendTaskContext(threadId);
+        const auto context     = detail::getBackendLogContext(threadId);
+        if (!taskContext.empty() || !context.empty())
+        {
+            logStatement = addContext(logStatement, logMessage, taskContext, context);
+        }
+
+        auto* route = m_router.find(loggerName);
+        if (route == nullptr)
+        {
+            TBase::write_log(logMetadata, logTimestamp, threadId, threadName, processId, loggerName, logLevel,
+                logLevelDescription, logLevelShortCode, namedArgs, logMessage, logStatement);
+            return;
+        }
+
+        if (route->category != nullptr)
+        {
+            const auto levelIndex = static_cast<size_t>(logLevel);
+            if (levelIndex < kLogLevelsCount)
+            {
+                incrementCounter(route->category->messagesByLevel[levelIndex]);
+            }
+
+            const auto now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                                                       .count());
+            route->category->queueLatency.record(now > logTimestamp ? now - logTimestamp : 0);
+            route->category->callSites.record(logMetadata, logMessage.size());
+        }
+
+        if (logLevel < route->logLevel.load(std::memory_order_relaxed))
+        {
+            incrementCounter(route->counters.filteredMessages);
+            return;
+        }
+
+        auto& coalescing     = route->coalescing;
+        const auto windowNs = coalescing.windowNs.load(std::memory_order_relaxed);
+        if (windowNs != 0)
+        {
+            const auto hash = getMessageHash(logMetadata, logMessage, threadId, taskContext, context);
+            if (hash == coalescing.lastHash && coalescing.metadata != nullptr &&
+                logTimestamp - coalescing.runStartTimestamp <= windowNs)
+            {
+                ++coalescing.repeats;
+                incrementCounter(route->counters.coalescedMessages);
+                return;
+            }
+
+            writeRepeats(*route);
+
+            coalescing.lastHash            = hash;
+            coalescing.runStartTimestamp   = logTimestamp;
+            coalescing.metadata            = logMetadata;
+            coalescing.loggerName          = loggerName;
+            coalescing.logLevel            = logLevel;
+            coalescing.logLevelDescription = logLevelDescription;
+            coalescing.logLevelShortCode   = logLevelShortCode;
+            coalescing.statement.assign(logStatement);
+            coalescing.messageOffset = logStatement.rfind(logMessage);
+            coalescing.messageSize   = logMessage.size();
+        }
+
+        write(*route, logMetadata, logTimestamp, threadId, threadName, processId, loggerName, logLevel,
+            logLevelDescription, logLevelShortCode, namedArgs, logMessage, logStatement);
+
+        // Backend runs periodic tasks only when it is idle, under constant load they are run from here
+        if (++m_messagesSincePeriodicTasks >= kMessagesPerPeriodicTasksRun)
+        {
+            m_messagesSincePeriodicTasks = 0;
+            m_router.runPeriodicTasks();
+        }
+    }
+
+    void run_periodic_tasks() noexcept override
+    {
+        writeExpiredRepeats();
+        TBase::run_periodic_tasks();
+        m_messagesSincePeriodicTasks = 0;
+        m_router.runPeriodicTasks();
+    }
+
+private:
+    // Message is last part of pattern, only line break follows it
+    static size_t findMessageOffset(std::string_view logStatement, std::string_view logMessage) noexcept
+    {
+        auto line = logStatement;
+        if (line.ends_with('\n'))
+        {
+            line.remove_suffix(1);
+        }
+        return line.ends_with(logMessage) ? line.size() - logMessage.size() : std::string_view::npos;
+    }
+
+    // Scope message ends with raw nanoseconds of its named argument, text sinks show them in readable units
+    void formatScopeDuration(std::string_view& logStatement, std::string_view& logMessage, uint64_t durationNs)
+    {
+        const auto messageOffset = findMessageOffset(logStatement, logMessage);
+        if (messageOffset == std::string_view::npos)
+        {
+            return;
+        }
+
+        // Label is followed by " took ", so trailing digits are duration
+        m_scopeMessage.assign(logMessage, 0, logMessage.find_last_not_of("0123456789") + 1);
+        appendScopeDuration(m_scopeMessage, durationNs);
+
+        m_scopeStatement.assign(logStatement, 0, messageOffset);
+        m_scopeStatement.append(m_scopeMessage);
+        m_scopeStatement.append(logStatement, messageOffset + logMessage.size());
+
+        logMessage   = m_scopeMessage;
+        logStatement = m_scopeStatement;
+    }
+
+    // Task and thread contexts are placed right before message, so they follow category column
+    std::string_view addContext(std::string_view logStatement, std::string_view logMessage, std::string_view taskContext,
+        std::string_view context)
+    {
+        const auto messageOffset = findMessageOffset(logStatement, logMessage);
+        if (messageOffset == std::string_view::npos)
+        {
+            return logStatement;
+        }
+
+        m_contextStatement.assign(logStatement, 0, messageOffset);
+        for (const auto field : {taskContext, context})
+        {
+            if (!field.empty())
+            {
+                m_contextStatement += '[';
+                m_contextStatement += field;
+                m_contextStatement += "] ";
+            }
+        }
+        m_contextStatement.append(logStatement, messageOffset);
+        return m_contextStatement;
+    }
+
+    // Messages of other threads or with other context are not repeats, even with same text
+    static uint64_t getMessageHash(quill::MacroMetadata const* logMetadata, std::string_view logMessage,
+        std::string_view threadId, std::string_view taskContext, std::string_view context) noexcept
+    {
+        constexpr uint64_t kGoldenRatio = 0x9E3779B97F4A7C15ULL;
+
+        auto hash = reinterpret_cast<uintptr_t>(logMetadata) * kGoldenRatio;
+        for (const auto field : {logMessage, threadId, taskContext, context})
+        {
+            hash = (hash ^ std::hash<std::string_view>{}(field)) * kGoldenRatio;
+        }
+        return hash;
+    }
+
+    void write(SinkRoute& route, quill::MacroMetadata const* logMetadata, uint64_t logTimestamp, std::string_view threadId,
+        std::string_view threadName, std::string const& processId, std::string_view loggerName, quill::LogLevel logLevel,
+        std::string_view logLevelDescription, std::string_view logLevelShortCode,
+        std::vector<std::pair<std::string, std::string>> const* namedArgs, std::string_view logMessage,
+        std::string_view logStatement)
+    {
+        const auto writeStart = std::chrono::steady_clock::now();
+        TBase::write_log(logMetadata, logTimestamp, threadId, threadName, processId, loggerName, logLevel,
+            logLevelDescription, logLevelShortCode, namedArgs, logMessage, logStatement);
+        const auto writeDuration = std::chrono::steady_clock::now() - writeStart;
+
+        incrementCounter(route.counters.writtenMessages);
+        incrementCounter(route.counters.writtenBytes, logStatement.size());
+        route.writeLatency.record(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(writeDuration).count()));
+    }
+
+    // Writes summary line of collapsed messages with pattern of last written message
+    void writeRepeats(SinkRoute& route)
+    {
+        auto& coalescing = route.coalescing;
+        if (coalescing.repeats == 0)
+        {
+            return;
+        }
+
+        if (coalescing.messageOffset != std::string::npos)
+        {
+            const auto message = "last message repeated " + std::to_string(coalescing.repeats) + " times";
+
+            m_repeatsStatement.assign(coalescing.statement, 0, coalescing.messageOffset);
+            m_repeatsStatement.append(message);
+            m_repeatsStatement.append(coalescing.statement, coalescing.messageOffset + coalescing.messageSize);
+
+            write(route, coalescing.metadata, coalescing.runStartTimestamp, {}, {}, kNoProcessId, coalescing.loggerName,
+                coalescing.logLevel, coalescing.logLevelDescription, coalescing.logLevelShortCode, nullptr, message,
+                m_repeatsStatement);
+        }
+
+        coalescing.repeats  = 0;
+        coalescing.lastHash = 0;
+        coalescing.metadata = nullptr;
+    }
+
+    // Storm may end without next message, so pending summaries are written once their window is over
+    void writeExpiredRepeats()
+    {
+        const auto now = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+                .count());
+
+        m_router.forEachRoute(
+            [&](SinkRoute& route)
+            {
+                const auto& coalescing = route.coalescing;
+                if (coalescing.repeats != 0 &&
+                    now - coalescing.runStartTimestamp > coalescing.windowNs.load(std::memory_order_relaxed))
+                {
+                    writeRepeats(route);
+                }
+            });
+    }
+
+    static constexpr uint32_t kMessagesPerPeriodicTasksRun = 4096;
+
+    inline static const std::string kNoProcessId;
+
+    SinkRouter m_router;
+    uint32_t m_messagesSincePeriodicTasks = 0;
+    std::string m_repeatsStatement;
+    std::string m_contextStatement;
+    std::string m_scopeMessage;
+    std::string m_scopeStatement;
+};
+}  // namespace logger
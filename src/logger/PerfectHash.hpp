@@ -0,0 +1,126 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace logger {
+// Collision free table of strings known at compile time, built by hash and displace: keys are split to buckets by
+// first hash, then seed of second hash is searched for each bucket, so all its keys take free slots. Lookup costs two
+// hashes and one string comparison
+template <size_t N>
+class PerfectHash
+{
+public:
+    consteval explicit PerfectHash(const std::array<std::string_view, N>& keys) : m_keys(keys)
+    {
+        std::array<size_t, kBucketsCount> bucketSizes{};
+        std::array<size_t, N> keyBuckets{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            keyBuckets[i] = getBucket(keys[i]);
+            ++bucketSizes[keyBuckets[i]];
+        }
+
+        // Keys of same bucket are adjacent, largest buckets are placed first while table is empty
+        std::array<size_t, N> order{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(),
+            [&keyBuckets, &bucketSizes](size_t lhs, size_t rhs)
+            {
+                const auto lhsBucket = keyBuckets[lhs];
+                const auto rhsBucket = keyBuckets[rhs];
+                if (bucketSizes[lhsBucket] != bucketSizes[rhsBucket])
+                {
+                    return bucketSizes[lhsBucket] > bucketSizes[rhsBucket];
+                }
+                return lhsBucket < rhsBucket;
+            });
+
+        m_slots.fill(kEmptySlot);
+        for (size_t begin = 0; begin < N;)
+        {
+            const auto bucket = keyBuckets[order[begin]];
+            const auto end    = begin + bucketSizes[bucket];
+
+            uint32_t seed = 1;
+            while (!tryPlace(order, begin, end, seed))
+            {
+                ++seed;
+            }
+            m_seeds[bucket] = seed;
+            begin           = end;
+        }
+    }
+
+    // Index of key in array passed to constructor
+    constexpr std::optional<size_t> find(std::string_view key) const noexcept
+    {
+        const auto index = m_slots[getSlot(key, m_seeds[getBucket(key)])];
+        if (index == kEmptySlot || m_keys[index] != key)
+        {
+            return std::nullopt;
+        }
+        return index;
+    }
+
+private:
+    static constexpr size_t kBucketsCount = std::bit_ceil(N);
+    static constexpr size_t kSlotsCount   = std::bit_ceil(N) * 2;
+    static constexpr uint32_t kEmptySlot  = UINT32_MAX;
+
+    // FNV-1a
+    static constexpr uint64_t hash(std::string_view key, uint64_t seed) noexcept
+    {
+        constexpr uint64_t kOffsetBasis = 14695981039346656037ULL;
+        constexpr uint64_t kPrime       = 1099511628211ULL;
+        constexpr uint64_t kGoldenRatio = 0x9E3779B97F4A7C15ULL;
+
+        uint64_t result = kOffsetBasis ^ (seed * kGoldenRatio);
+        for (const char c : key)
+        {
+            result ^= static_cast<uint8_t>(c);
+            result *= kPrime;
+        }
+        return result ^ (result >> 32);
+    }
+
+    static constexpr size_t getBucket(std::string_view key) noexcept
+    {
+        return hash(key, 0) & (kBucketsCount - 1);
+    }
+
+    static constexpr size_t getSlot(std::string_view key, uint32_t seed) noexcept
+    {
+        return hash(key, seed) & (kSlotsCount - 1);
+    }
+
+    constexpr bool tryPlace(const std::array<size_t, N>& order, size_t begin, size_t end, uint32_t seed)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto& slot = m_slots[getSlot(m_keys[order[i]], seed)];
+            if (slot != kEmptySlot)
+            {
+                for (size_t j = begin; j < i; ++j)
+                {
+                    m_slots[getSlot(m_keys[order[j]], seed)] = kEmptySlot;
+                }
+                return false;
+            }
+            slot = static_cast<uint32_t>(order[i]);
+        }
+        return true;
+    }
+
+    std::array<std::string_view, N> m_keys;
+    std::array<uint32_t, kBucketsCount> m_seeds{};
+    std::array<uint32_t, kSlotsCount> m_slots{};
+};
+}  // namespace logger
@@ -0,0 +1,101 @@
+﻿#include "PeriodicReporter.hpp"
+
+#include <algorithm>
+
+logger::PeriodicReporter::~PeriodicReporter()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_isStopped = true;
+    }
+    m_changed.notify_all();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+logger::PeriodicReporter::TaskId logger::PeriodicReporter::addTask(Task task, std::chrono::nanoseconds interval)
+{
+    TaskId taskId = 0;
+    {
+        std::lock_guard lock(m_mutex);
+        taskId = m_tasks.size();
+        m_tasks.push_back(ScheduledTask{std::move(task), interval, std::chrono::steady_clock::now() + interval});
+        if (!m_thread.joinable() && !m_isStopped)
+        {
+            m_thread = std::thread([this]() { run(); });
+        }
+    }
+    m_changed.notify_all();
+    return taskId;
+}
+
+void logger::PeriodicReporter::setTaskInterval(TaskId taskId, std::chrono::nanoseconds interval)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (taskId >= m_tasks.size())
+        {
+            return;
+        }
+        m_tasks[taskId].interval = interval;
+        m_tasks[taskId].nextRun  = std::chrono::steady_clock::now() + interval;
+    }
+    m_changed.notify_all();
+}
+
+void logger::PeriodicReporter::run()
+{
+    std::vector<Task> dueTasks;
+
+    std::unique_lock lock(m_mutex);
+    while (!m_isStopped)
+    {
+        // Paused tasks don't wake thread, it waits for change of tasks then
+        auto nextRun = std::chrono::steady_clock::time_point::max();
+        for (const auto& task : m_tasks)
+        {
+            if (task.interval.count() != 0)
+            {
+                nextRun = std::min(nextRun, task.nextRun);
+            }
+        }
+
+        if (nextRun == std::chrono::steady_clock::time_point::max())
+        {
+            m_changed.wait(lock);
+            continue;
+        }
+        if (m_changed.wait_until(lock, nextRun) == std::cv_status::no_timeout)
+        {
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        dueTasks.clear();
+        for (auto& task : m_tasks)
+        {
+            if (task.interval.count() != 0 && task.nextRun <= now)
+            {
+                task.nextRun = now + task.interval;
+                dueTasks.push_back(task.task);
+            }
+        }
+
+        // Tasks log, so they run without lock and tasks may be changed meanwhile
+        lock.unlock();
+        for (const auto& task : dueTasks)
+        {
+            task();
+        }
+        lock.lock();
+    }
+}
+
+logger::PeriodicReporter& logger::getPeriodicReporter()
+{
+    static PeriodicReporter reporter;
+    return reporter;
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logger {
+// Runs report tasks, e.g. periodic statistics of logger modules, on own thread. Backend thread can't log, so reports
+// which are logged as messages are made here. Thread sleeps until nearest task is due, so it wakes only as often as
+// shortest interval of enabled reports
+class PeriodicReporter
+{
+public:
+    using Task   = std::function<void()>;
+    using TaskId = size_t;
+
+    PeriodicReporter() = default;
+    ~PeriodicReporter();
+
+    PeriodicReporter(const PeriodicReporter&)            = delete;
+    PeriodicReporter& operator=(const PeriodicReporter&) = delete;
+
+    // Task runs every interval, zero interval pauses it. Thread is started by first task
+    TaskId addTask(Task task, std::chrono::nanoseconds interval);
+    void setTaskInterval(TaskId taskId, std::chrono::nanoseconds interval);
+
+private:
+    struct ScheduledTask
+    {
+        Task task;
+        std::chrono::nanoseconds interval;
+        std::chrono::steady_clock::time_point nextRun;
+    };
+
+    void run();
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::vector<ScheduledTask> m_tasks;
+    bool m_isStopped = false;
+    std::thread m_thread;
+};
+
+// Created on first use, thread of reporter is joined on exit
+PeriodicReporter& getPeriodicReporter();
+}  // namespace logger
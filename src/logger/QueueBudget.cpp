@@ -0,0 +1,229 @@
+﻿#include "QueueBudget.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<bool> logger::detail::s_queueBudgetExceeded{false};
+
+namespace {
+constexpr auto kBudgetUpdateInterval = std::chrono::milliseconds(1);
+constexpr auto kIdleQueueTimeout     = std::chrono::seconds(1);
+
+// Blocked thread stops waiting when budget is not updated, e.g. backend is not started yet
+constexpr auto kBackendStallTimeout = std::chrono::milliseconds(100);
+constexpr auto kBlockPollInterval   = std::chrono::microseconds(50);
+
+struct AccountEntry
+{
+    logger::ThreadQueueAccount* account;
+
+    // Used only by backend thread
+    uint64_t lastMessages = 0;
+    std::chrono::steady_clock::time_point lastActive;
+};
+
+struct QueueBudgetState
+{
+    std::atomic<uint64_t> budgetBytes{0};
+    std::atomic<logger::QueueBudgetPolicy> policy{logger::QueueBudgetPolicy::Grow};
+
+    std::atomic<uint64_t> currentBytes{0};
+    std::atomic<uint64_t> peakBytes{0};
+    std::atomic<uint64_t> droppedMessages{0};
+    std::atomic<uint64_t> blockedMessages{0};
+    std::atomic<uint64_t> shrunkQueues{0};
+    std::atomic<uint64_t> largestQueueBytes{0};
+
+    // Steady clock time of last budget update by backend thread
+    std::atomic<int64_t> lastUpdateNs{0};
+
+    std::mutex accountsMutex;
+    std::vector<AccountEntry> accounts;
+
+    // Used only by backend thread
+    std::chrono::steady_clock::time_point lastUpdate;
+};
+
+// Leaked, so accounts of threads exiting after static destruction are still removed safely
+QueueBudgetState& getQueueBudgetState() noexcept
+{
+    static auto* state = new QueueBudgetState;
+    return *state;
+}
+
+int64_t getSteadyNowNs() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void updateMaximum(std::atomic<uint64_t>& maximum, uint64_t value) noexcept
+{
+    auto current = maximum.load(std::memory_order_relaxed);
+    while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+bool shrinkQueue(logger::ThreadQueueAccount& account) noexcept
+{
+    constexpr auto kInitialCapacity = logger::FrontendOptions::initial_queue_capacity;
+    if (account.capacity.load(std::memory_order_relaxed) <= kInitialCapacity)
+    {
+        return false;
+    }
+
+    // Old queue is freed by backend after it is drained
+    logger::Frontend::shrink_thread_local_queue(kInitialCapacity);
+    getQueueBudgetState().shrunkQueues.fetch_add(1, std::memory_order_relaxed);
+
+    account.capacity.store(logger::Frontend::get_thread_local_queue_capacity(), std::memory_order_relaxed);
+    return true;
+}
+}  // namespace
+
+logger::ThreadQueueAccount::ThreadQueueAccount()
+{
+    auto& state = getQueueBudgetState();
+
+    std::lock_guard lock(state.accountsMutex);
+    state.accounts.push_back(AccountEntry{this, 0, std::chrono::steady_clock::now()});
+}
+
+logger::ThreadQueueAccount::~ThreadQueueAccount()
+{
+    auto& state = getQueueBudgetState();
+
+    std::lock_guard lock(state.accountsMutex);
+    std::erase_if(state.accounts, [this](const AccountEntry& entry) { return entry.account == this; });
+}
+
+void logger::setQueueMemoryBudget(size_t bytes, QueueBudgetPolicy policy) noexcept
+{
+    auto& state = getQueueBudgetState();
+    state.policy.store(policy, std::memory_order_relaxed);
+    state.budgetBytes.store(bytes, std::memory_order_relaxed);
+
+    // Exceeded budget is set by backend on next update
+    if (bytes == 0)
+    {
+        detail::s_queueBudgetExceeded.store(false, std::memory_order_relaxed);
+    }
+}
+
+void logger::shrinkThisThreadQueue() noexcept
+{
+    auto& account = getThreadQueueAccount();
+    detail::updateThreadQueueCapacity(account);
+    shrinkQueue(account);
+}
+
+logger::QueueMemoryStats logger::getQueueMemoryStats() noexcept
+{
+    const auto& state = getQueueBudgetState();
+    return QueueMemoryStats{state.currentBytes.load(std::memory_order_relaxed),
+        state.peakBytes.load(std::memory_order_relaxed), state.budgetBytes.load(std::memory_order_relaxed),
+        state.droppedMessages.load(std::memory_order_relaxed), state.blockedMessages.load(std::memory_order_relaxed),
+        state.shrunkQueues.load(std::memory_order_relaxed), state.largestQueueBytes.load(std::memory_order_relaxed)};
+}
+
+void logger::detail::updateThreadQueueCapacity(ThreadQueueAccount& account) noexcept
+{
+    account.messagesSinceCheck = 0;
+    account.capacity.store(logger::Frontend::get_thread_local_queue_capacity(), std::memory_order_relaxed);
+
+    // Idle queue is drained, so it is shrunk before next message is enqueued
+    if (account.shrinkRequested.exchange(false, std::memory_order_relaxed))
+    {
+        shrinkQueue(account);
+    }
+}
+
+bool logger::detail::onQueueBudgetExceeded(ThreadQueueAccount& account) noexcept
+{
+    auto& state       = getQueueBudgetState();
+    const auto policy = state.policy.load(std::memory_order_relaxed);
+    if (policy == QueueBudgetPolicy::Grow)
+    {
+        return true;
+    }
+
+    // Thread which logs while budget is exceeded gives its own extra memory back first
+    updateThreadQueueCapacity(account);
+    shrinkQueue(account);
+
+    if (policy == QueueBudgetPolicy::Drop)
+    {
+        state.droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Queues of other threads are shrunk by themselves or by idle timeout, budget is recomputed by backend thread
+    state.blockedMessages.fetch_add(1, std::memory_order_relaxed);
+    while (s_queueBudgetExceeded.load(std::memory_order_relaxed))
+    {
+        const auto sinceUpdateNs = getSteadyNowNs() - state.lastUpdateNs.load(std::memory_order_relaxed);
+        if (std::chrono::nanoseconds(sinceUpdateNs) > kBackendStallTimeout)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(kBlockPollInterval);
+    }
+    return true;
+}
+
+void logger::detail::updateQueueBudget() noexcept
+{
+    auto& state    = getQueueBudgetState();
+    const auto now = std::chrono::steady_clock::now();
+    if (now - state.lastUpdate < kBudgetUpdateInterval)
+    {
+        return;
+    }
+    state.lastUpdate = now;
+
+    constexpr auto kInitialCapacity = logger::FrontendOptions::initial_queue_capacity;
+
+    uint64_t currentBytes = 0;
+    uint64_t usedBytes    = 0;
+    {
+        std::lock_guard lock(state.accountsMutex);
+        for (auto& entry : state.accounts)
+        {
+            const auto capacity = entry.account->capacity.load(std::memory_order_relaxed);
+            const auto messages = entry.account->messages.load(std::memory_order_relaxed);
+            currentBytes += capacity;
+            updateMaximum(state.largestQueueBytes, capacity);
+
+            if (messages != entry.lastMessages)
+            {
+                entry.lastMessages = messages;
+                entry.lastActive   = now;
+            }
+
+            // Queue at initial capacity takes no budget, otherwise many threads could keep budget exceeded forever
+            if (capacity <= kInitialCapacity)
+            {
+                continue;
+            }
+
+            // Idle queue is shrunk before it is used again, so it can't take more memory and is not counted in budget
+            if (now - entry.lastActive >= kIdleQueueTimeout)
+            {
+                entry.account->shrinkRequested.store(true, std::memory_order_relaxed);
+                continue;
+            }
+            usedBytes += capacity - kInitialCapacity;
+        }
+    }
+
+    state.currentBytes.store(currentBytes, std::memory_order_relaxed);
+    updateMaximum(state.peakBytes, currentBytes);
+
+    const auto budget = state.budgetBytes.load(std::memory_order_relaxed);
+    s_queueBudgetExceeded.store(budget != 0 && usedBytes > budget, std::memory_order_relaxed);
+    state.lastUpdateNs.store(getSteadyNowNs(), std::memory_order_relaxed);
+}
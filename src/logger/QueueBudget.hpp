@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "Frontend.hpp"
+#include "LoggerStats.hpp"
+
+namespace logger {
+// Action taken by logging thread while frontend queues of all threads take more memory than budget
+enum class QueueBudgetPolicy : uint8_t
+{
+    Block,  // Wait until queues of other threads are shrunk below budget
+    Drop,   // Drop message
+    Grow,   // Only report usage
+};
+
+// Frontend queues of all threads are process wide, so budget is shared by all logger modules. Only capacity over
+// initial one is counted, since every logging thread allocates initial capacity anyway. Zero budget is unlimited
+void setQueueMemoryBudget(size_t bytes, QueueBudgetPolicy policy) noexcept;
+
+// Gives memory of queue of calling thread back, if it grew over initial capacity. Idle queues are shrunk
+// automatically, thread pools can call it to do it right when worker goes idle
+void shrinkThisThreadQueue() noexcept;
+
+QueueMemoryStats getQueueMemoryStats() noexcept;
+
+// Capacity of queue of one thread as seen by budget. Accounts are registered for backend periodic task, which sums
+// them. Queue of exited thread is freed by backend once drained, so account is removed by destructor
+struct ThreadQueueAccount
+{
+    static constexpr uint32_t kMessagesPerCapacityCheck = 256;
+
+    // Written by owning thread, read by backend thread
+    std::atomic<size_t> capacity{0};
+    std::atomic<uint64_t> messages{0};
+
+    // Set by backend thread when queue stays idle over initial capacity, owning thread shrinks it on next message
+    std::atomic<bool> shrinkRequested{false};
+
+    uint32_t messagesSinceCheck = kMessagesPerCapacityCheck - 1;
+
+    ThreadQueueAccount();
+    ~ThreadQueueAccount();
+
+    ThreadQueueAccount(const ThreadQueueAccount&)            = delete;
+    ThreadQueueAccount& operator=(const ThreadQueueAccount&) = delete;
+};
+
+inline ThreadQueueAccount& getThreadQueueAccount() noexcept
+{
+    thread_local ThreadQueueAccount account;
+    return account;
+}
+
+namespace detail {
+extern std::atomic<bool> s_queueBudgetExceeded;
+
+void updateThreadQueueCapacity(ThreadQueueAccount& account) noexcept;
+bool onQueueBudgetExceeded(ThreadQueueAccount& account) noexcept;
+
+// Called by backend thread. Sums queues of all threads, requests shrinking of idle queues and updates budget state
+void updateQueueBudget() noexcept;
+}  // namespace detail
+
+// Called by logging defines before message is encoded. Usual cost is thread local counter and two relaxed loads,
+// queue capacity of thread is checked only every few messages
+inline bool acquireQueueBudget() noexcept
+{
+    auto& account = getThreadQueueAccount();
+    account.messages.store(account.messages.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (++account.messagesSinceCheck >= ThreadQueueAccount::kMessagesPerCapacityCheck ||
+        account.shrinkRequested.load(std::memory_order_relaxed))
+    {
+        detail::updateThreadQueueCapacity(account);
+    }
+
+    if (!detail::s_queueBudgetExceeded.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+    return detail::onQueueBudgetExceeded(account);
+}
+}  // namespace logger
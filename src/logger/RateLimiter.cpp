@@ -0,0 +1,47 @@
+﻿#include "RateLimiter.hpp"
+
+#include <functional>
+#include <thread>
+
+void logger::TokenBucket::configure(double ratePerSecond, double burst) noexcept
+{
+    constexpr double kNanosecondsInSecond = 1e9;
+
+    m_emissionIntervalNs = static_cast<int64_t>(kNanosecondsInSecond / ratePerSecond);
+    m_burstToleranceNs   = static_cast<int64_t>(burst * static_cast<double>(m_emissionIntervalNs));
+}
+
+void logger::TokenBucket::countSuppressed() noexcept
+{
+    thread_local const size_t shard = std::hash<std::thread::id>{}(std::this_thread::get_id()) % kSuppressedShardsCount;
+    m_suppressed[shard].count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t logger::TokenBucket::takeSuppressed() noexcept
+{
+    uint64_t suppressed = 0;
+    for (auto& shard : m_suppressed)
+    {
+        suppressed += shard.count.exchange(0, std::memory_order_relaxed);
+    }
+    return suppressed;
+}
+
+logger::CategoryRateLimiter::CategoryRateLimiter(double ratePerSecond, double burst, bool perLevel) noexcept
+    : m_perLevel(perLevel)
+{
+    for (auto& bucket : m_buckets)
+    {
+        bucket.configure(ratePerSecond, burst);
+    }
+}
+
+uint64_t logger::CategoryRateLimiter::takeSuppressed() noexcept
+{
+    uint64_t suppressed = 0;
+    for (auto& bucket : m_buckets)
+    {
+        suppressed += bucket.takeSuppressed();
+    }
+    return suppressed;
+}
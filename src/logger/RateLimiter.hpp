@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <quill/core/LogLevel.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "LoggerStats.hpp"
+
+namespace logger {
+// Token bucket implemented as GCRA: whole state is one timestamp changed by single CAS
+class TokenBucket
+{
+public:
+    void configure(double ratePerSecond, double burst) noexcept;
+
+    bool tryAcquire(int64_t nowNs) noexcept
+    {
+        auto theoreticalArrivalNs = m_theoreticalArrivalNs.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const auto newTheoreticalArrivalNs = std::max(theoreticalArrivalNs, nowNs) + m_emissionIntervalNs;
+            if (newTheoreticalArrivalNs - nowNs > m_burstToleranceNs)
+            {
+                countSuppressed();
+                return false;
+            }
+
+            if (m_theoreticalArrivalNs.compare_exchange_weak(
+                    theoreticalArrivalNs, newTheoreticalArrivalNs, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+    }
+
+    // Returns suppressed messages count since previous call. Called by reporter thread
+    uint64_t takeSuppressed() noexcept;
+
+private:
+    // Suppressed messages are counted in shards, so storm from many threads doesn't fight for one cache line
+    struct alignas(64) SuppressedShard
+    {
+        std::atomic<uint64_t> count{0};
+    };
+
+    static constexpr size_t kSuppressedShardsCount = 8;
+
+    void countSuppressed() noexcept;
+
+    alignas(64) std::atomic<int64_t> m_theoreticalArrivalNs{0};
+    int64_t m_emissionIntervalNs = 0;
+    int64_t m_burstToleranceNs   = 0;
+
+    std::array<SuppressedShard, kSuppressedShardsCount> m_suppressed;
+};
+
+// Created only for categories with RateLimit setting. Either one bucket for all levels or one bucket per level
+class CategoryRateLimiter
+{
+public:
+    CategoryRateLimiter(double ratePerSecond, double burst, bool perLevel) noexcept;
+
+    bool tryAcquire(quill::LogLevel logLevel) noexcept
+    {
+        const auto nowNs =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        const auto levelIndex = static_cast<size_t>(logLevel);
+        return m_buckets[m_perLevel && levelIndex < kLogLevelsCount ? levelIndex : 0].tryAcquire(nowNs);
+    }
+
+    uint64_t takeSuppressed() noexcept;
+
+private:
+    std::array<TokenBucket, kLogLevelsCount> m_buckets;
+    bool m_perLevel;
+};
+}  // namespace logger
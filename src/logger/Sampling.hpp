@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include <quill/core/Rdtsc.h>
+
+#include <cstdint>
+#include <limits>
+
+namespace logger {
+inline constexpr uint64_t kSampleAlways = std::numeric_limits<uint64_t>::max();
+
+// Rate is probability of message to be logged, 0.0 - 1.0
+constexpr uint64_t getSampleThreshold(double rate) noexcept
+{
+    constexpr double kTwoPow64 = 18446744073709551616.0;
+
+    if (rate >= 1.0)
+    {
+        return kSampleAlways;
+    }
+    if (rate <= 0.0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>(rate * kTwoPow64);
+}
+
+// xorshift64* with thread local state, no synchronization
+inline uint64_t getSampleRandom() noexcept
+{
+    constexpr uint64_t kSplitMixIncrement = 0x9E3779B97F4A7C15ULL;
+    constexpr uint64_t kMultiplier        = 0x2545F4914F6CDD1DULL;
+
+    thread_local uint64_t state = (quill::detail::rdtsc() ^ reinterpret_cast<uintptr_t>(&state)) * kSplitMixIncrement | 1U;
+
+    state ^= state >> 12U;
+    state ^= state << 25U;
+    state ^= state >> 27U;
+    return state * kMultiplier;
+}
+
+inline bool shouldSample(uint64_t threshold) noexcept
+{
+    return threshold == kSampleAlways || getSampleRandom() < threshold;
+}
+}  // namespace logger
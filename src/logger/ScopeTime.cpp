@@ -0,0 +1,45 @@
+﻿#include "ScopeTime.hpp"
+
+#include <charconv>
+#include <iterator>
+
+std::optional<uint64_t> logger::getScopeDurationNs(quill::MacroMetadata const* logMetadata,
+    std::vector<std::pair<std::string, std::string>> const* namedArgs) noexcept
+{
+    if (logMetadata == nullptr || namedArgs == nullptr || namedArgs->size() != 1 ||
+        namedArgs->front().first != kScopeTimeArgName)
+    {
+        return std::nullopt;
+    }
+
+    // Scope message is identified by its format string
+    if (!std::string_view(logMetadata->message_format()).ends_with(kScopeTimeFormatSuffix))
+    {
+        return std::nullopt;
+    }
+
+    const auto& text        = namedArgs->front().second;
+    uint64_t durationNs     = 0;
+    const auto* end         = text.data() + text.size();
+    const auto [ptr, error] = std::from_chars(text.data(), end, durationNs);
+    if (error != std::errc{} || ptr != end)
+    {
+        return std::nullopt;
+    }
+    return durationNs;
+}
+
+void logger::appendScopeDuration(std::string& out, uint64_t durationNs)
+{
+    constexpr std::pair<uint64_t, std::string_view> kUnits[] = {{1'000'000'000, "s"}, {1'000'000, "ms"}, {1'000, "us"}};
+
+    for (const auto& [unitNs, unitName] : kUnits)
+    {
+        if (durationNs >= unitNs)
+        {
+            fmtquill::format_to(std::back_inserter(out), "{:.3f}{}", static_cast<double>(durationNs) / unitNs, unitName);
+            return;
+        }
+    }
+    fmtquill::format_to(std::back_inserter(out), "{}ns", durationNs);
+}
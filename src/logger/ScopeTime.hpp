@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include <quill/Backend.h>
+#include <quill/DeferredFormatCodec.h>
+#include <quill/core/MacroMetadata.h>
+#include <quill/core/Rdtsc.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Frontend.hpp"
+
+namespace logger {
+// Raw TSC values pushed by scope timer. Conversion to nanoseconds and formatting are done by backend thread
+struct TscDuration
+{
+    uint64_t startTsc;
+    uint64_t elapsedTsc;
+};
+
+// Scope time is logged with named argument holding raw nanoseconds, so sinks get exact duration. Text sinks show it
+// in readable units. Format string of scope message is "<label>" + kScopeTimeFormatSuffix
+#define CAT_LOG_SCOPE_TIME_FORMAT_SUFFIX " took {scope_duration}"
+
+inline constexpr std::string_view kScopeTimeFormatSuffix = CAT_LOG_SCOPE_TIME_FORMAT_SUFFIX;
+inline constexpr std::string_view kScopeTimeArgName      = "scope_duration";
+
+// Duration of scope message in nanoseconds, nullopt for other messages. Called by backend thread
+std::optional<uint64_t> getScopeDurationNs(quill::MacroMetadata const* logMetadata,
+    std::vector<std::pair<std::string, std::string>> const* namedArgs) noexcept;
+
+// Appends duration as "123ns", "12.345us", "12.345ms" or "1.234s"
+void appendScopeDuration(std::string& out, uint64_t durationNs);
+
+template <class TLogStatement>
+class ScopeTimer
+{
+public:
+    ScopeTimer(logger::Logger* logger, quill::LogLevel logLevel, TLogStatement logStatement) noexcept
+        : m_logger(logger->should_log_statement(logLevel) ? logger : nullptr), m_logStatement(logStatement)
+    {
+        if (m_logger != nullptr)
+        {
+            m_startTsc = quill::detail::rdtsc();
+        }
+    }
+
+    ~ScopeTimer()
+    {
+        if (m_logger != nullptr)
+        {
+            const auto elapsedTsc = quill::detail::rdtsc() - m_startTsc;
+            m_logStatement(m_logger, TscDuration{m_startTsc, elapsedTsc});
+        }
+    }
+
+    ScopeTimer(const ScopeTimer&)            = delete;
+    ScopeTimer& operator=(const ScopeTimer&) = delete;
+
+private:
+    logger::Logger* m_logger;
+    TLogStatement m_logStatement;
+    uint64_t m_startTsc = 0;
+};
+}  // namespace logger
+
+template <>
+struct quill::Codec<logger::TscDuration> : quill::DeferredFormatCodec<logger::TscDuration>
+{
+};
+
+template <>
+struct fmtquill::formatter<logger::TscDuration>
+{
+    constexpr auto parse(fmtquill::format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    auto format(const logger::TscDuration& duration, fmtquill::format_context& ctx) const
+    {
+        const auto startNs = quill::Backend::convert_rdtsc_to_epoch_time(duration.startTsc);
+        const auto endNs   = quill::Backend::convert_rdtsc_to_epoch_time(duration.startTsc + duration.elapsedTsc);
+        return fmtquill::format_to(ctx.out(), "{}", endNs - startNs);
+    }
+};
+
+#define CAT_LOG_CONCAT_IMPL(a, b) a##b
+#define CAT_LOG_CONCAT(a, b)      CAT_LOG_CONCAT_IMPL(a, b)
+
+// Scope message passes rate limit and queue budget of category on exit, like other messages of module
+#define CAT_LOG_SCOPE_TIME_IMPL(quillMacro, level, logName, catName, cat, label)                                             \
+    logger::ScopeTimer CAT_LOG_CONCAT(catLogScopeTimer, __LINE__)(GET_LOGGER(logName, cat, catName), quill::LogLevel::level, \
+        [](logger::Logger* scopeTimerLogger, logger::TscDuration duration)                                                   \
+        {                                                                                                                    \
+            if (logger::s_##logName##Logger.canEnqueue(logger::catName::cat, quill::LogLevel::level))                        \
+            {                                                                                                                \
+                quillMacro(scopeTimerLogger, label CAT_LOG_SCOPE_TIME_FORMAT_SUFFIX, duration);                              \
+            }                                                                                                                \
+        })
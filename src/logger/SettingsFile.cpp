@@ -0,0 +1,156 @@
+﻿#include "SettingsFile.hpp"
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr std::string_view kTemporaryFileSuffix = ".tmp";
+
+// Other processes may rewrite same settings file, so temporary file name is unique: "<file>.<pid>.<random>.tmp"
+std::filesystem::path getTemporaryPath(const std::filesystem::path& path)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    const auto processId = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+    const auto processId = static_cast<long>(getpid());
+#endif
+
+    std::random_device randomDevice;
+    auto temporaryPath = path;
+    temporaryPath += "." + std::to_string(processId) + "." + std::to_string(randomDevice()) + kTemporaryFileSuffix.data();
+    return temporaryPath;
+}
+
+// Creates new file, writes content and flushes it to disk, so renamed file is complete after power loss. File is
+// removed if it is not written
+bool writeNewFile(const std::filesystem::path& path, std::string_view content)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    DWORD written  = 0;
+    bool isWritten = WriteFile(file, content.data(), static_cast<DWORD>(content.size()), &written, nullptr) &&
+                     written == content.size() && FlushFileBuffers(file);
+    isWritten      = CloseHandle(file) && isWritten;
+#else
+    const int file = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    bool isWritten = true;
+    for (size_t offset = 0; offset < content.size() && isWritten;)
+    {
+        const auto written = write(file, content.data() + offset, content.size() - offset);
+        isWritten          = written > 0;
+        offset += isWritten ? static_cast<size_t>(written) : 0;
+    }
+    isWritten = fsync(file) == 0 && isWritten;
+    isWritten = close(file) == 0 && isWritten;
+#endif
+
+    if (!isWritten)
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+    return isWritten;
+}
+}  // namespace
+
+logger::MappedFile::MappedFile(const std::string& fileName)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        // View keeps mapping alive after its handle is closed
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            const auto* data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (data != nullptr)
+            {
+                m_content = std::string_view(data, static_cast<size_t>(size.QuadPart));
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    const int file = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        return;
+    }
+
+    struct stat status{};
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        const auto size = static_cast<size_t>(status.st_size);
+        void* data      = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data != MAP_FAILED)
+        {
+            m_content = std::string_view(static_cast<const char*>(data), size);
+        }
+    }
+    close(file);
+#endif
+}
+
+logger::MappedFile::~MappedFile()
+{
+    if (m_content.empty())
+    {
+        return;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    UnmapViewOfFile(m_content.data());
+#else
+    munmap(const_cast<char*>(m_content.data()), m_content.size());
+#endif
+}
+
+bool logger::replaceFileContent(const std::string& fileName, std::string_view content)
+{
+    const std::filesystem::path path(fileName);
+    const auto temporaryPath = getTemporaryPath(path);
+
+    if (!writeNewFile(temporaryPath, content))
+    {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,194 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace logger {
+constexpr std::string_view kUtf8Bom = "\xEF\xBB\xBF";
+
+using SettingsValueBuffer = std::array<char, 32>;
+
+// Read only content of file mapped to memory. Empty if file doesn't exist
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& fileName);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view getContent() const noexcept
+    {
+        return m_content;
+    }
+
+private:
+    std::string_view m_content;
+};
+
+// Content is written to unique temporary file in same directory, which is flushed and renamed over settings file, so
+// file is never seen partially written, even by other processes
+bool replaceFileContent(const std::string& fileName, std::string_view content);
+
+struct SettingsLine
+{
+    enum class Type : uint8_t
+    {
+        Other,  // Empty line or comment
+        Section,
+        Value
+    };
+
+    Type type = Type::Other;
+    std::string_view text;  // Whole line without line break
+    std::string_view name;  // Section name or key
+    std::string_view value;
+};
+
+constexpr std::string_view trimSettingsText(std::string_view text) noexcept
+{
+    constexpr std::string_view kWhitespaces = " \t\r";
+
+    const auto begin = text.find_first_not_of(kWhitespaces);
+    if (begin == std::string_view::npos)
+    {
+        return {};
+    }
+    return text.substr(begin, text.find_last_not_of(kWhitespaces) - begin + 1);
+}
+
+// Section names and keys are compared ignoring ASCII case, as SimpleIni did before
+constexpr bool equalsSettingsName(std::string_view lhs, std::string_view rhs) noexcept
+{
+    const auto toLower = [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+    return std::ranges::equal(lhs, rhs, [toLower](char lhsChar, char rhsChar) { return toLower(lhsChar) == toLower(rhsChar); });
+}
+
+// Index of name among count names ignoring case. Exact lookup is tried by callers first, so this runs only for names
+// written in other case
+template <class TGetName>
+constexpr std::optional<size_t> findSettingsName(std::string_view name, size_t count, TGetName&& getName)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (equalsSettingsName(name, getName(i)))
+        {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+constexpr SettingsLine parseSettingsLine(std::string_view text) noexcept
+{
+    SettingsLine line;
+    line.text = text;
+
+    const auto trimmed = trimSettingsText(text);
+    if (trimmed.empty() || trimmed.front() == ';' || trimmed.front() == '#')
+    {
+        return line;
+    }
+
+    if (trimmed.front() == '[' && trimmed.back() == ']')
+    {
+        line.type = SettingsLine::Type::Section;
+        line.name = trimSettingsText(trimmed.substr(1, trimmed.size() - 2));
+        return line;
+    }
+
+    const auto separator = trimmed.find('=');
+    if (separator == std::string_view::npos || separator == 0)
+    {
+        return line;
+    }
+
+    line.type  = SettingsLine::Type::Value;
+    line.name  = trimSettingsText(trimmed.substr(0, separator));
+    line.value = trimSettingsText(trimmed.substr(separator + 1));
+    return line;
+}
+
+// One pass over INI content, views of lines point into content, so nothing is copied or allocated
+template <class TCallback>
+void forEachSettingsLine(std::string_view content, TCallback&& callback)
+{
+    if (content.starts_with(kUtf8Bom))
+    {
+        content.remove_prefix(kUtf8Bom.size());
+    }
+
+    while (!content.empty())
+    {
+        const auto lineEnd = content.find('\n');
+        auto text          = content.substr(0, lineEnd);
+        content            = lineEnd == std::string_view::npos ? std::string_view{} : content.substr(lineEnd + 1);
+
+        if (text.ends_with('\r'))
+        {
+            text.remove_suffix(1);
+        }
+        callback(parseSettingsLine(text));
+    }
+}
+
+template <class T>
+std::optional<T> parseSettingsValue(std::string_view value) noexcept
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        constexpr std::array<std::string_view, 4> kTrueValues  = {"true", "yes", "on", "1"};
+        constexpr std::array<std::string_view, 4> kFalseValues = {"false", "no", "off", "0"};
+
+        const auto equalsIgnoreCase = [value](std::string_view expected)
+        {
+            return std::ranges::equal(value, expected,
+                [](char lhs, char rhs) { return std::tolower(static_cast<unsigned char>(lhs)) == rhs; });
+        };
+
+        if (std::ranges::any_of(kTrueValues, equalsIgnoreCase))
+        {
+            return true;
+        }
+        if (std::ranges::any_of(kFalseValues, equalsIgnoreCase))
+        {
+            return false;
+        }
+        return std::nullopt;
+    }
+    else
+    {
+        T result{};
+        const auto* end               = value.data() + value.size();
+        const auto [parsedEnd, error] = std::from_chars(value.data(), end, result);
+        if (error != std::errc{} || parsedEnd != end)
+        {
+            return std::nullopt;
+        }
+        return result;
+    }
+}
+
+// Shortest text, which is parsed back to same value
+template <class T>
+std::string_view formatSettingsValue(T value, SettingsValueBuffer& buffer) noexcept
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        return value ? "true" : "false";
+    }
+    else
+    {
+        const auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        return error == std::errc{} ? std::string_view(buffer.data(), end) : std::string_view{};
+    }
+}
+}  // namespace logger
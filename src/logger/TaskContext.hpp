@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace logger {
+// Context of logical task, e.g. request served by coroutines which hop threads of work stealing pool. Task ID is
+// written as "[task=ID parent=SPAN]" after category column instead of meaningless thread ID
+struct TaskContext
+{
+    uint64_t taskId       = 0;
+    uint64_t parentSpanId = 0;  // Zero if task has no parent span
+
+    // Context with new process unique task ID
+    static TaskContext create(uint64_t parentSpanId = 0) noexcept;
+};
+
+namespace detail {
+// Current context is only pointer, so switching it costs pointer store. Context sent to backend is compared with
+// current one when message is logged, and ID is compared too as freed context may be reused at same address
+struct TaskContextThreadState
+{
+    const TaskContext* current = nullptr;
+    const TaskContext* sent    = nullptr;
+    uint64_t sentTaskId        = 0;
+    uint64_t sentParentSpanId  = 0;
+};
+
+inline constinit thread_local TaskContextThreadState t_taskContextState;
+
+// Sends current context of thread, first call makes empty context be sent when thread exits
+void sendTaskContext();
+void logTaskContext(TaskContextThreadState& state);
+
+// Called by logging defines before message is enqueued
+inline void syncTaskContext()
+{
+    const auto& state = t_taskContextState;
+    if (state.current != state.sent ||
+        (state.current != nullptr &&
+            (state.current->taskId != state.sentTaskId || state.current->parentSpanId != state.sentParentSpanId)))
+    {
+        sendTaskContext();
+    }
+}
+
+// Called only by backend thread. Empty if thread has no task context
+std::string_view getBackendTaskContext(std::string_view threadId);
+}  // namespace detail
+
+// Context must outlive time it is current, returns previous one
+inline const TaskContext* setCurrentTaskContext(const TaskContext* context) noexcept
+{
+    auto& state          = detail::t_taskContextState;
+    const auto* previous = state.current;
+    state.current        = context;
+    return previous;
+}
+
+inline const TaskContext* getCurrentTaskContext() noexcept
+{
+    return detail::t_taskContextState.current;
+}
+
+// Task context for scope, e.g. while executor runs task
+class TaskContextScope
+{
+public:
+    explicit TaskContextScope(const TaskContext* context) noexcept : m_previous(setCurrentTaskContext(context))
+    {
+    }
+
+    ~TaskContextScope()
+    {
+        setCurrentTaskContext(m_previous);
+    }
+
+    TaskContextScope(const TaskContextScope&)            = delete;
+    TaskContextScope& operator=(const TaskContextScope&) = delete;
+
+private:
+    const TaskContext* m_previous;
+};
+
+// Base of coroutine promise type which keeps task context in coroutine frame. Coroutine started inside task continues
+// it, otherwise new task is created
+class TaskContextPromise
+{
+public:
+    TaskContextPromise() noexcept
+        : m_taskContext(getCurrentTaskContext() != nullptr ? *getCurrentTaskContext() : TaskContext::create())
+    {
+    }
+
+    const TaskContext& getTaskContext() const noexcept
+    {
+        return m_taskContext;
+    }
+
+    // Changed before first resume, e.g. to ID of request received from other service
+    void setTaskContext(TaskContext context) noexcept
+    {
+        m_taskContext = context;
+    }
+
+private:
+    TaskContext m_taskContext;
+};
+
+// Executors resume coroutines by it, so messages logged until coroutine suspends carry its task context
+template <class TPromise>
+    requires std::is_base_of_v<TaskContextPromise, TPromise>
+void resumeWithTaskContext(std::coroutine_handle<TPromise> handle)
+{
+    TaskContextScope scope(&handle.promise().getTaskContext());
+    handle.resume();
+}
+}  // namespace logger
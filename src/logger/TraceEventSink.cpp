@@ -0,0 +1,183 @@
+﻿#include "TraceEventSink.hpp"
+
+#include <quill/core/MacroMetadata.h>
+
+#include "ScopeTime.hpp"
+
+namespace {
+constexpr double kNanosecondsInMicrosecond = 1000.0;
+
+uint64_t getNowNs() noexcept
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void appendJsonString(std::string& out, std::string_view value)
+{
+    out += '"';
+    for (const char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < ' ')
+        {
+            out += ' ';
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    out += '"';
+}
+}  // namespace
+
+logger::TraceEventSink::~TraceEventSink()
+{
+    stop();
+}
+
+bool logger::TraceEventSink::start(const std::filesystem::path& path, std::chrono::nanoseconds duration)
+{
+    std::lock_guard lock(m_mutex);
+    closeLocked();
+
+    m_file = std::fopen(path.string().c_str(), "w");
+    if (m_file == nullptr)
+    {
+        return false;
+    }
+
+    m_buffer    = "[\n";
+    m_hasEvents = false;
+    m_startNs   = getNowNs();
+    m_stopAtNs  = duration.count() > 0 ? m_startNs + static_cast<uint64_t>(duration.count()) : 0;
+    m_namedThreads.clear();
+    m_active.store(true, std::memory_order_release);
+    return true;
+}
+
+void logger::TraceEventSink::stop()
+{
+    std::lock_guard lock(m_mutex);
+    closeLocked();
+}
+
+void logger::TraceEventSink::closeLocked()
+{
+    m_active.store(false, std::memory_order_release);
+    if (m_file == nullptr)
+    {
+        return;
+    }
+
+    m_buffer += "\n]\n";
+    writeBufferLocked();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+void logger::TraceEventSink::writeBufferLocked()
+{
+    if (m_file != nullptr && !m_buffer.empty())
+    {
+        std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    }
+    m_buffer.clear();
+}
+
+void logger::TraceEventSink::stopIfExpiredLocked(uint64_t timestamp)
+{
+    if (m_stopAtNs != 0 && timestamp >= m_stopAtNs)
+    {
+        closeLocked();
+    }
+}
+
+void logger::TraceEventSink::write_log(quill::MacroMetadata const* logMetadata, uint64_t logTimestamp,
+    std::string_view threadId, std::string_view threadName, std::string const& processId, std::string_view loggerName,
+    quill::LogLevel /*logLevel*/, std::string_view /*logLevelDescription*/, std::string_view /*logLevelShortCode*/,
+    std::vector<std::pair<std::string, std::string>> const* namedArgs, std::string_view /*logMessage*/,
+    std::string_view /*logStatement*/)
+{
+    if (!m_active.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    // Scope timer logs right after measuring, so message timestamp is end of scope
+    const auto durationNs = getScopeDurationNs(logMetadata, namedArgs);
+    if (!durationNs.has_value())
+    {
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+    stopIfExpiredLocked(logTimestamp);
+    if (m_file == nullptr)
+    {
+        return;
+    }
+
+    if (!threadName.empty() && m_namedThreads.find(threadId) == m_namedThreads.end())
+    {
+        m_namedThreads.emplace(threadId);
+        m_buffer += m_hasEvents ? ",\n" : "";
+        m_buffer += R"({"name":"thread_name","ph":"M","pid":)" + processId + R"(,"tid":)" + std::string(threadId) +
+                    R"(,"args":{"name":)";
+        appendJsonString(m_buffer, threadName);
+        m_buffer += "}}";
+        m_hasEvents = true;
+    }
+
+    const auto startUs = (static_cast<double>(logTimestamp) - static_cast<double>(*durationNs) - static_cast<double>(m_startNs)) /
+                         kNanosecondsInMicrosecond;
+
+    // Label is taken from format string of scope message
+    const std::string_view format = logMetadata->message_format();
+
+    m_buffer += m_hasEvents ? ",\n" : "";
+    m_buffer += R"({"name":)";
+    appendJsonString(m_buffer, format.substr(0, format.size() - kScopeTimeFormatSuffix.size()));
+    m_buffer += R"(,"cat":)";
+    appendJsonString(m_buffer, loggerName);
+    m_buffer += R"(,"ph":"X","ts":)" + std::to_string(startUs) +
+                R"(,"dur":)" + std::to_string(static_cast<double>(*durationNs) / kNanosecondsInMicrosecond) +
+                R"(,"pid":)" + processId + R"(,"tid":)" + std::string(threadId) + "}";
+    m_hasEvents = true;
+
+    if (m_buffer.size() >= kChunkSize)
+    {
+        writeBufferLocked();
+    }
+}
+
+void logger::TraceEventSink::flush_sink()
+{
+    if (!m_active.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+    writeBufferLocked();
+    if (m_file != nullptr)
+    {
+        std::fflush(m_file);
+    }
+}
+
+void logger::TraceEventSink::run_periodic_tasks() noexcept
+{
+    if (!m_active.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+    stopIfExpiredLocked(getNowNs());
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include <quill/sinks/Sink.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace logger {
+// Writes scope timing events in Chrome JSON trace format (chrome://tracing, ui.perfetto.dev).
+// Capture is started and stopped at runtime, events are streamed to file in chunks, so memory stays bounded
+class TraceEventSink final : public quill::Sink
+{
+public:
+    ~TraceEventSink() override;
+
+    // Zero duration captures until stop() is called. Returns false if file could not be opened
+    bool start(const std::filesystem::path& path, std::chrono::nanoseconds duration);
+    void stop();
+
+    bool isActive() const noexcept
+    {
+        return m_active.load(std::memory_order_acquire);
+    }
+
+    void write_log(quill::MacroMetadata const* logMetadata, uint64_t logTimestamp, std::string_view threadId,
+        std::string_view threadName, std::string const& processId, std::string_view loggerName, quill::LogLevel logLevel,
+        std::string_view logLevelDescription, std::string_view logLevelShortCode,
+        std::vector<std::pair<std::string, std::string>> const* namedArgs, std::string_view logMessage,
+        std::string_view logStatement) override;
+
+    void flush_sink() override;
+    void run_periodic_tasks() noexcept override;
+
+private:
+    void writeBufferLocked();
+    void closeLocked();
+    void stopIfExpiredLocked(uint64_t timestamp);
+
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    std::atomic<bool> m_active{false};
+
+    std::mutex m_mutex;
+    std::FILE* m_file = nullptr;
+    std::string m_buffer;
+    bool m_hasEvents    = false;
+    uint64_t m_startNs  = 0;
+    uint64_t m_stopAtNs = 0;
+    std::set<std::string, std::less<>> m_namedThreads;
+};
+}  // namespace logger
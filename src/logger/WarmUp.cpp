@@ -0,0 +1,46 @@
+﻿#include "WarmUp.hpp"
+
+#include <quill/Backend.h>
+#include <quill/LogMacros.h>
+#include <quill/sinks/NullSink.h>
+
+#include <string>
+#include <string_view>
+
+#include "Frontend.hpp"
+#include "QueueBudget.hpp"
+
+namespace {
+constexpr std::string_view kWarmUpLoggerName = "WarmUp";
+constexpr size_t kWarmUpMessageSize          = 4096;
+
+logger::Logger* getWarmUpLogger()
+{
+    static auto* warmUpLogger = logger::Frontend::create_or_get_logger(
+        kWarmUpLoggerName.data(), logger::Frontend::create_or_get_sink<quill::NullSink>(kWarmUpLoggerName.data()));
+    return warmUpLogger;
+}
+}  // namespace
+
+void logger::prefaultThisThreadQueue()
+{
+    logger::Frontend::preallocate();
+
+    auto* warmUpLogger  = getWarmUpLogger();
+    const auto capacity = logger::Frontend::get_thread_local_queue_capacity();
+    const std::string message(kWarmUpMessageSize, ' ');
+
+    // Message header takes few bytes more, so queue is left with some space and never grows here
+    for (size_t written = 0; written + 2 * kWarmUpMessageSize <= capacity; written += kWarmUpMessageSize)
+    {
+        QUILL_LOG_INFO(warmUpLogger, "{}", std::string_view(message));
+    }
+
+    // Flush waits for backend, without it filler messages stay in queue until backend is started
+    if (quill::Backend::is_running())
+    {
+        warmUpLogger->flush_log();
+    }
+
+    detail::updateThreadQueueCapacity(getThreadQueueAccount());
+}
@@ -0,0 +1,16 @@
+﻿#pragma once
+
+namespace logger {
+struct WarmUpOptions
+{
+    // Write whole queue of thread once, so its pages are faulted in before real messages
+    bool prefaultQueue = true;
+
+    // Log one message to each category at lowest enabled level, so encoding path of categories is warm too
+    bool encodeCategoryMessages = false;
+};
+
+// Allocates frontend queue of calling thread and faults its pages in. Messages are written by logger with null sink
+// and flushed only when backend is running, before backend start they take queue space until it is started
+void prefaultThisThreadQueue();
+}  // namespace logger